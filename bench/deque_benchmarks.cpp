@@ -0,0 +1,698 @@
+//
+// Benchmarks for BoundedPriorityDeque.hpp
+//
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <set>
+#include <vector>
+#include "include/BoundedPriorityDeque.hpp"
+
+static constexpr size_t kKeyCount = 1 << 16;
+
+static const std::vector<double>& randomKeys() {
+    static const std::vector<double> keys = [] {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+        std::vector<double> result(kKeyCount);
+        for (auto& key : result) key = distribution(generator);
+        return result;
+    }();
+    return keys;
+}
+
+/**
+ * @brief Search policies pinning the insertion strategy, to locate the crossover of the linear small-k path.
+ */
+struct SearchOnly : BinarySearch {
+    static constexpr size_t linearLimit = 0;
+};
+
+struct LinearOnly : BinarySearch {
+    static constexpr size_t linearLimit = std::numeric_limits<size_t>::max();
+};
+
+/**
+ * @brief The approximate deque over the [0, 1) range of the benchmark keys, constructible from k alone.
+ */
+struct UnitApproximateDeque : ApproximateBoundedPriorityDeque<double, int> {
+    explicit UnitApproximateDeque(size_t k) : ApproximateBoundedPriorityDeque(k, 0.0, 1.0) {}
+};
+
+enum class KeyOrder { Random, Ascending, Descending };
+
+/**
+ * @brief The benchmark keys in the given order.
+ *
+ * Ascending keys are rejected by a full min-deque on the first comparison, descending keys are all accepted
+ * at the top and evict the bottom, random keys are mostly rejected once the bound has tightened.
+ */
+static const std::vector<double>& orderedKeys(KeyOrder order) {
+    static const std::array<std::vector<double>, 3> keys = [] {
+        std::array<std::vector<double>, 3> result { randomKeys(), randomKeys(), randomKeys() };
+        std::ranges::sort(result[1]);
+        std::ranges::sort(result[2], std::greater<>());
+        return result;
+    }();
+    return keys[static_cast<size_t>(order)];
+}
+
+/**
+ * @brief A 256 byte payload, large enough that interleaving it with the keys spoils the search locality.
+ */
+struct LargePayload {
+    std::array<int, 64> data {};
+
+    LargePayload() = default;
+    explicit LargePayload(int seed) { data[0] = seed; }
+};
+
+/**
+ * @brief Cost per push of random keys, the bulk of the work in k-NN style accumulation.
+ */
+template<typename Deque>
+static void BM_PushRandom(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        Deque deque(k);
+        for (size_t i = 0; i < kKeyCount; ++i) deque.emplace(keys[i], static_cast<int>(i));
+        benchmark::DoNotOptimize(deque.topK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief Same workload as BM_PushRandom loaded through a single pushRange() call.
+ */
+template<typename Deque>
+static void BM_PushRange(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    std::vector<BoundingPair<double, int>> elements(kKeyCount);
+    for (size_t i = 0; i < kKeyCount; ++i) elements[i] = { keys[i], static_cast<int>(i) };
+    for (auto _ : state) {
+        Deque deque(k);
+        deque.pushRange(elements.begin(), elements.end());
+        benchmark::DoNotOptimize(deque.topK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief Cost per push when every candidate is accepted at a random position.
+ *
+ * The top is discarded whenever the deque fills, so each push runs the full search and shift.
+ */
+template<typename Deque>
+static void BM_PushAccepted(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        Deque deque(k);
+        for (size_t i = 0; i < kKeyCount; ++i) {
+            if (deque.full()) deque.discardTop();
+            deque.emplace(keys[i], static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(deque.topK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief A short-lived deque per query, 64 candidates each, allocating its buffer from the global heap.
+ */
+static void BM_PerQueryHeap(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    size_t offset = 0;
+    for (auto _ : state) {
+        BoundedMinPriorityDeque<double, int> deque(k);
+        for (size_t i = 0; i < 64; ++i) deque.emplace(keys[offset + i], static_cast<int>(i));
+        benchmark::DoNotOptimize(deque.bottomK());
+        offset = (offset + 64) & (kKeyCount - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Same per-query deque placed in a monotonic arena that is released after every query.
+ */
+static void BM_PerQueryArena(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    std::vector<std::byte> memory(1 << 16);
+    std::pmr::monotonic_buffer_resource arena(memory.data(), memory.size());
+    size_t offset = 0;
+    for (auto _ : state) {
+        {
+            BoundedMinPriorityDeque<double, int, ExactCapacity, PmrInterleavedLayout> deque(k, &arena);
+            for (size_t i = 0; i < 64; ++i) deque.emplace(keys[offset + i], static_cast<int>(i));
+            benchmark::DoNotOptimize(deque.bottomK());
+        }
+        arena.release();
+        offset = (offset + 64) & (kKeyCount - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static constexpr size_t kBatchQueries = 64;
+
+/**
+ * @brief A batch of 64 queries with a deque each, every query offered 64 candidates one round at a time.
+ */
+static void BM_BatchSeparateDeques(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    size_t offset = 0;
+    for (auto _ : state) {
+        std::vector<BoundedMinPriorityDeque<double, int>> deques(kBatchQueries, BoundedMinPriorityDeque<double, int>(k));
+        for (int round = 0; round < 64; ++round) {
+            for (size_t query = 0; query < kBatchQueries; ++query) deques[query].emplace(keys[offset + query], round);
+            offset = (offset + kBatchQueries) & (kKeyCount - 1);
+        }
+        benchmark::DoNotOptimize(deques.back().bottomK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBatchQueries));
+}
+
+/**
+ * @brief Same batch in a single BoundedPriorityDequeBatch, a round being one pushAll() over every query.
+ */
+static void BM_BatchPushAll(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    std::vector<int> values(kBatchQueries);
+    size_t offset = 0;
+    for (auto _ : state) {
+        BoundedPriorityDequeBatch<double, int> batch(kBatchQueries, k);
+        for (int round = 0; round < 64; ++round) {
+            std::ranges::fill(values, round);
+            batch.pushAll(std::span(keys).subspan(offset, kBatchQueries), values);
+            offset = (offset + kBatchQueries) & (kKeyCount - 1);
+        }
+        benchmark::DoNotOptimize(batch.bottomK(kBatchQueries - 1));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBatchQueries));
+}
+
+/**
+ * @brief A deque of large capacity that only ever sees a handful of candidates, as in a sparse query.
+ *
+ * Measures what creating the buffer costs on top of the pushes, a value is only built for an accepted element.
+ */
+template<typename Deque>
+static void BM_ConstructSparse(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    size_t offset = 0;
+    for (auto _ : state) {
+        Deque deque(k);
+        for (size_t i = 0; i < 8; ++i) deque.emplace(keys[offset + i], static_cast<int>(i));
+        benchmark::DoNotOptimize(deque.bottomK());
+        offset = (offset + 8) & (kKeyCount - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief An adaptive-k search, the bound alternates between k / 4 and k with 16 pushes after every change.
+ */
+template<typename Deque, bool Reserve>
+static void BM_AdaptiveResize(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    Deque deque(k / 4);
+    if constexpr (Reserve) deque.reserve(k);
+    size_t offset = 0, round = 0;
+    for (auto _ : state) {
+        deque.resize(++round % 2 == 0 ? k / 4 : k);
+        for (size_t i = 0; i < 16; ++i) deque.emplace(keys[offset + i], static_cast<int>(i));
+        benchmark::DoNotOptimize(deque.bottomK());
+        offset = (offset + 16) & (kKeyCount - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+enum class Walk { Index, Iterator, Spans };
+
+/**
+ * @brief Reads every element of a full, wrapped deque in priority order.
+ */
+template<typename Deque, Walk How>
+static void BM_WalkInOrder(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    Deque deque(k);
+    for (size_t i = 0; i < kKeyCount; ++i) deque.emplace(keys[i], static_cast<int>(i));
+    for (size_t i = 0; i < k / 2; ++i) deque.discardTop();
+    for (size_t i = 0; i < k / 2; ++i) deque.emplace(1.0 + static_cast<double>(i), static_cast<int>(i));
+    for (auto _ : state) {
+        double sum = 0;
+        if constexpr (How == Walk::Index) {
+            for (size_t i = 0; i < deque.size(); ++i) sum += deque[i].key;
+        } else if constexpr (How == Walk::Iterator) {
+            for (const auto& element : deque) sum += element.key;
+        } else {
+            for (auto run : deque.as_spans()) {
+                for (const auto& element : run) sum += element.key;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * deque.size()));
+}
+
+enum class Reload { Rebuild, Deserialize, View };
+
+/**
+ * @brief Restores a stored full deque: pushing its elements back, deserialize(), or a view over the record.
+ */
+template<Reload How>
+static void BM_Reload(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    BoundedMinPriorityDeque<double, int> stored(k);
+    for (size_t i = 0; i < kKeyCount; ++i) stored.emplace(keys[i], static_cast<int>(i));
+    std::vector<BoundingPair<double, int>> elements(stored.begin(), stored.end());
+    std::vector<std::byte> record(stored.serializedSize());
+    stored.serialize(record);
+
+    for (auto _ : state) {
+        if constexpr (How == Reload::Rebuild) {
+            BoundedMinPriorityDeque<double, int> deque(k);
+            for (const auto& element : elements) deque.emplace(element.key, element.value);
+            benchmark::DoNotOptimize(deque.bottomK());
+        } else if constexpr (How == Reload::Deserialize) {
+            BoundedMinPriorityDeque<double, int> deque(k);
+            deque.deserialize(record);
+            benchmark::DoNotOptimize(deque.bottomK());
+        } else {
+            BoundedPriorityDequeView<double, int> view(record);
+            benchmark::DoNotOptimize(view.bottomK());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * k));
+}
+
+/**
+ * @brief Push throughput of a min-deque over random, ascending or descending keys.
+ */
+template<typename Deque, KeyOrder Order>
+static void BM_PushOrdered(benchmark::State& state) {
+    const auto& keys = orderedKeys(Order);
+    const auto k = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        Deque deque(k);
+        for (size_t i = 0; i < kKeyCount; ++i) deque.emplace(keys[i], static_cast<int>(i));
+        benchmark::DoNotOptimize(deque.topK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief The k smallest of the random keys with std::priority_queue, a max-heap popped whenever it exceeds k.
+ */
+template<KeyOrder Order>
+static void BM_StdPriorityQueue(benchmark::State& state) {
+    const auto& keys = orderedKeys(Order);
+    const auto k = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        std::priority_queue<BoundingPair<double, int>> heap;
+        for (size_t i = 0; i < kKeyCount; ++i) {
+            if (heap.size() == k) {
+                if (!(keys[i] < heap.top().key)) continue;
+                heap.pop();
+            }
+            heap.push({ keys[i], static_cast<int>(i) });
+        }
+        benchmark::DoNotOptimize(heap.top().key);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief The k smallest of the random keys with std::multiset, erasing the largest whenever it exceeds k.
+ */
+template<KeyOrder Order>
+static void BM_StdMultiset(benchmark::State& state) {
+    const auto& keys = orderedKeys(Order);
+    const auto k = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        std::multiset<BoundingPair<double, int>> set;
+        for (size_t i = 0; i < kKeyCount; ++i) {
+            if (set.size() == k) {
+                if (!(keys[i] < std::prev(set.end())->key)) continue;
+                set.erase(std::prev(set.end()));
+            }
+            set.insert({ keys[i], static_cast<int>(i) });
+        }
+        benchmark::DoNotOptimize(set.begin()->key);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief The k smallest of the random keys with std::partial_sort over a copy of all candidates.
+ */
+template<KeyOrder Order>
+static void BM_StdPartialSort(benchmark::State& state) {
+    const auto& keys = orderedKeys(Order);
+    const auto k = static_cast<size_t>(state.range(0));
+    std::vector<BoundingPair<double, int>> elements;
+    elements.reserve(kKeyCount);
+    for (auto _ : state) {
+        elements.clear();
+        for (size_t i = 0; i < kKeyCount; ++i) elements.push_back({ keys[i], static_cast<int>(i) });
+        std::partial_sort(elements.begin(), elements.begin() + static_cast<std::ptrdiff_t>(k), elements.end());
+        benchmark::DoNotOptimize(elements.front().key);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief Cost per push of keys arriving in improving order, every push lands at the top and evicts the bottom.
+ *
+ * The typical pattern of a best-first traversal, where candidates get closer as the search converges.
+ */
+template<typename Deque>
+static void BM_PushImproving(benchmark::State& state) {
+    const auto k = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        Deque deque(k);
+        for (size_t i = 0; i < kKeyCount; ++i) deque.emplace(static_cast<double>(kKeyCount - i), static_cast<int>(i));
+        benchmark::DoNotOptimize(deque.topK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief Hand-rolled sharding, 64 local deques filled independently and folded with operator+=().
+ */
+template<typename Deque>
+static void BM_LocalsFillAndFold(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        std::vector<Deque> locals(64, Deque(k));
+        for (size_t i = 0; i < kKeyCount; ++i) locals[i & 63].emplace(keys[i], static_cast<int>(i));
+        Deque result(k);
+        for (const auto& local : locals) result += local;
+        benchmark::DoNotOptimize(result.bottomK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief Same workload through ShardedBoundedPriorityDeque, shards prune against the shared threshold.
+ */
+template<typename Deque>
+static void BM_ShardedFillAndCollect(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        ShardedBoundedPriorityDeque<Deque> sharded(k, 64);
+        for (size_t i = 0; i < kKeyCount; ++i) sharded.local(i & 63).emplace(keys[i], static_cast<int>(i));
+        benchmark::DoNotOptimize(sharded.collect().bottomK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief parallelTopK() over the key range, one std::jthread per chunk when Threads, else tasks run inline.
+ *
+ * The inline run isolates the cost of chunking, the per-task shards and the final merge from the threading.
+ */
+template<bool Threads>
+static void BM_ParallelTopK(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<size_t>(state.range(0));
+    auto key = [](double value) { return value; };
+    for (auto _ : state) {
+        if constexpr (Threads) benchmark::DoNotOptimize(parallelTopK(keys, k, key).bottomK());
+        else benchmark::DoNotOptimize(parallelTopK(keys, k, key, [](auto task) { task(); }, 16).bottomK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief One shared top-k fed by every benchmark thread through a std::mutex, the pattern being replaced.
+ */
+static void BM_SharedPushMutex(benchmark::State& state) {
+    static std::unique_ptr<BoundedMinPriorityDeque<double, int>> shared;
+    static std::mutex mutex;
+    if (state.thread_index() == 0) shared = std::make_unique<BoundedMinPriorityDeque<double, int>>(64);
+
+    const auto& keys = randomKeys();
+    size_t i = static_cast<size_t>(state.thread_index()) * 4099;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        shared->emplace(keys[i], static_cast<int>(i));
+        i = (i + 1) & (kKeyCount - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Same shared top-k through ConcurrentBoundedPriorityDeque.
+ */
+static void BM_SharedPushConcurrent(benchmark::State& state) {
+    static std::unique_ptr<ConcurrentBoundedPriorityDeque<double, int>> shared;
+    if (state.thread_index() == 0) {
+        shared = std::make_unique<ConcurrentBoundedPriorityDeque<double, int>>(64, static_cast<size_t>(state.threads()));
+    }
+
+    const auto& keys = randomKeys();
+    size_t i = static_cast<size_t>(state.thread_index()) * 4099;
+    for (auto _ : state) {
+        shared->emplace(keys[i], static_cast<int>(i));
+        i = (i + 1) & (kKeyCount - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Exposes the insertion offset search of a deque to the benchmarks.
+ */
+template<typename Deque>
+struct SearchProbe : Deque {
+    using Deque::Deque;
+
+    [[nodiscard]] size_t offsetOf(const double& key) const { return this->binarySearch(key); }
+};
+
+/**
+ * @brief Cost of locating the insertion offset of a random key in a full, wrapped deque, no shifting involved.
+ */
+template<typename Deque>
+static void BM_SearchFull(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    SearchProbe<Deque> deque(k);
+    for (size_t i = 0; i < kKeyCount && !deque.full(); ++i) deque.emplace(keys[i], static_cast<int>(i));
+    for (size_t i = 0; i < k / 3; ++i) {
+        deque.discardTop();
+        deque.emplace(keys[kKeyCount - 1 - i] * deque.bottomK(), 0);
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(deque.offsetOf(keys[i] * deque.bottomK()));
+        i = (i + 1) & (kKeyCount - 1);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/**
+ * @brief Pushes through a base reference from an out-of-line function, the way library code receives a deque.
+ *
+ * The concrete type is not visible here, so this measures what the comparison costs when it cannot be
+ * devirtualized by the optimizer.
+ */
+template<typename Base>
+[[gnu::noinline]] static void pushAll(Base& deque, const std::vector<double>& keys) {
+    for (size_t i = 0; i < keys.size(); ++i) deque.emplace(keys[i], static_cast<int>(i));
+}
+
+template<typename Deque, typename Base>
+static void BM_PushThroughBase(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        Deque deque(k);
+        pushAll<Base>(deque, keys);
+        benchmark::DoNotOptimize(deque.topK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeyCount));
+}
+
+/**
+ * @brief Folds 64 full thread-local deques into one result, the typical per-query reduction.
+ */
+template<typename Deque>
+static void BM_MergeLocals(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    std::vector<Deque> locals(64, Deque(k));
+    for (size_t i = 0; i < kKeyCount; ++i) locals[i % locals.size()].emplace(keys[i], static_cast<int>(i));
+
+    for (auto _ : state) {
+        Deque result(k);
+        for (const auto& local : locals) result += local;
+        benchmark::DoNotOptimize(result.bottomK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * locals.size() * k));
+}
+
+/**
+ * @brief Same reduction as BM_MergeLocals through a single k-way mergeAll() call.
+ */
+template<typename Deque>
+static void BM_MergeAllLocals(benchmark::State& state) {
+    const auto& keys = randomKeys();
+    const auto k = static_cast<unsigned int>(state.range(0));
+    std::vector<Deque> locals(64, Deque(k));
+    for (size_t i = 0; i < kKeyCount; ++i) locals[i % locals.size()].emplace(keys[i], static_cast<int>(i));
+    std::vector<const typename Deque::Base*> pointers;
+    for (const auto& local : locals) pointers.push_back(&local);
+
+    for (auto _ : state) {
+        Deque result(k);
+        Deque::mergeAll(pointers, result);
+        benchmark::DoNotOptimize(result.bottomK());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * locals.size() * k));
+}
+
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedMaxPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedPriorityDequeKeyed<double, int, std::greater<>>)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedMinPriorityDeque<double, int, Pow2Capacity>)->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK_TEMPLATE(BM_PushThroughBase, BoundedMinPriorityDeque<double, int>,
+                   BoundedPriorityDequeBase<double, int, std::less<double>>)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedMinPriorityDeque<double, LargePayload>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedMinPriorityDeque<double, LargePayload, ExactCapacity, SplitLayout>)
+        ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedMinPriorityDeque<double, LargePayload, ExactCapacity, SlabLayout>)
+        ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, LargePayload>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, LargePayload, ExactCapacity, SplitLayout>)
+        ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, LargePayload, ExactCapacity, SlabLayout>)
+        ->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(2)->Range(8, 256);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout>)
+        ->RangeMultiplier(2)->Range(8, 256);
+
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int, ExactCapacity, InterleavedLayout, BinarySearch, StableTies>)
+        ->RangeMultiplier(2)->Range(8, 256);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout, BinarySearch, StableTies>)
+        ->RangeMultiplier(2)->Range(8, 256);
+
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int, ExactCapacity, InterleavedLayout, SearchOnly>)
+        ->RangeMultiplier(2)->Range(4, 128);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int, ExactCapacity, InterleavedLayout, LinearOnly>)
+        ->RangeMultiplier(2)->Range(4, 128);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout, SearchOnly>)
+        ->RangeMultiplier(2)->Range(4, 128);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout, LinearOnly>)
+        ->RangeMultiplier(2)->Range(4, 128);
+BENCHMARK_TEMPLATE(BM_PushAccepted, StaticBoundedPriorityDeque<double, int, 10>)->Arg(10);
+BENCHMARK_TEMPLATE(BM_PushAccepted, StaticBoundedPriorityDeque<double, int, 10, std::less<double>,
+                                    InlineInterleavedLayout<10>, SearchOnly>)->Arg(10);
+
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedPriorityHeap<double, int>)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PushAccepted, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(4)->Range(1024, 16384);
+
+BENCHMARK_TEMPLATE(BM_PushRange, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_PushImproving, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK_TEMPLATE(BM_PushAccepted, StaticBoundedPriorityDeque<double, int, 8>)->Arg(8);
+BENCHMARK_TEMPLATE(BM_PushAccepted, StaticBoundedPriorityDeque<double, int, 16>)->Arg(16);
+BENCHMARK_TEMPLATE(BM_PushAccepted, StaticBoundedPriorityDeque<double, int, 64>)->Arg(64);
+BENCHMARK_TEMPLATE(BM_PushAccepted, StaticBoundedPriorityDeque<double, int, 16, std::less<double>, InlineSplitLayout<16>>)->Arg(16);
+BENCHMARK_TEMPLATE(BM_PushRandom, StaticBoundedPriorityDeque<double, int, 8>)->Arg(8);
+BENCHMARK_TEMPLATE(BM_PushRandom, StaticBoundedPriorityDeque<double, int, 64>)->Arg(64);
+
+BENCHMARK_TEMPLATE(BM_ConstructSparse, BoundedMinPriorityDeque<double, LargePayload>)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_ConstructSparse, BoundedMinPriorityDeque<double, std::vector<int>>)->RangeMultiplier(8)->Range(64, 4096);
+
+BENCHMARK_TEMPLATE(BM_AdaptiveResize, BoundedMinPriorityDeque<double, int>, false)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_AdaptiveResize, BoundedMinPriorityDeque<double, int>, true)->RangeMultiplier(8)->Range(64, 4096);
+
+BENCHMARK_TEMPLATE(BM_WalkInOrder, BoundedMinPriorityDeque<double, int>, Walk::Index)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_WalkInOrder, BoundedMinPriorityDeque<double, int>, Walk::Iterator)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_WalkInOrder, BoundedMinPriorityDeque<double, int>, Walk::Spans)->RangeMultiplier(8)->Range(64, 4096);
+
+BENCHMARK_TEMPLATE(BM_Reload, Reload::Rebuild)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_Reload, Reload::Deserialize)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_Reload, Reload::View)->RangeMultiplier(8)->Range(64, 4096);
+
+BENCHMARK(BM_PerQueryHeap)->RangeMultiplier(4)->Range(4, 64);
+BENCHMARK(BM_PerQueryArena)->RangeMultiplier(4)->Range(4, 64);
+BENCHMARK(BM_BatchSeparateDeques)->RangeMultiplier(4)->Range(4, 64);
+BENCHMARK(BM_BatchPushAll)->RangeMultiplier(4)->Range(4, 64);
+
+BENCHMARK_TEMPLATE(BM_SearchFull, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_TEMPLATE(BM_SearchFull, BoundedMinPriorityDeque<double, int, ExactCapacity, InterleavedLayout, BranchlessSearch>)
+        ->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_TEMPLATE(BM_SearchFull, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout>)
+        ->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_TEMPLATE(BM_SearchFull, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout, BranchlessSearch>)
+        ->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_TEMPLATE(BM_PushRandom, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout, BranchlessSearch>)
+        ->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK_TEMPLATE(BM_LocalsFillAndFold, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_ShardedFillAndCollect, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_ParallelTopK, true)->RangeMultiplier(8)->Range(8, 512)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ParallelTopK, false)->RangeMultiplier(8)->Range(8, 512);
+
+BENCHMARK(BM_SharedPushMutex)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_SharedPushConcurrent)->ThreadRange(1, 32)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_MergeLocals, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 1024);
+BENCHMARK_TEMPLATE(BM_MergeAllLocals, BoundedMinPriorityDeque<double, int>)->RangeMultiplier(8)->Range(8, 1024);
+
+// k-selection over 64k keys against the standard library, k from 1 to 16k
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedMinPriorityDeque<double, int>, KeyOrder::Random)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout>, KeyOrder::Random)
+        ->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedPriorityHeap<double, int>, KeyOrder::Random)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, LazyBoundedPriorityDeque<double, int>, KeyOrder::Random)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, UnitApproximateDeque, KeyOrder::Random)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdPriorityQueue, KeyOrder::Random)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdMultiset, KeyOrder::Random)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdPartialSort, KeyOrder::Random)->RangeMultiplier(8)->Range(1, 16384);
+
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedMinPriorityDeque<double, int>, KeyOrder::Ascending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout>, KeyOrder::Ascending)
+        ->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedPriorityHeap<double, int>, KeyOrder::Ascending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, LazyBoundedPriorityDeque<double, int>, KeyOrder::Ascending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, UnitApproximateDeque, KeyOrder::Ascending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdPriorityQueue, KeyOrder::Ascending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdMultiset, KeyOrder::Ascending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdPartialSort, KeyOrder::Ascending)->RangeMultiplier(8)->Range(1, 16384);
+
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedMinPriorityDeque<double, int>, KeyOrder::Descending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout>, KeyOrder::Descending)
+        ->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, BoundedPriorityHeap<double, int>, KeyOrder::Descending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, LazyBoundedPriorityDeque<double, int>, KeyOrder::Descending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_PushOrdered, UnitApproximateDeque, KeyOrder::Descending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdPriorityQueue, KeyOrder::Descending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdMultiset, KeyOrder::Descending)->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_TEMPLATE(BM_StdPartialSort, KeyOrder::Descending)->RangeMultiplier(8)->Range(1, 16384);
+
+BENCHMARK_MAIN();
@@ -14,10 +14,11 @@ class Pkg(ConanFile):
     topics = ("c++", "data structures", "algorithms", "performance")
     settings = "os", "compiler", "arch", "build_type"
     requires = [
-        "gtest/1.14.0"
+        "gtest/1.14.0",
+        "benchmark/1.8.3"
     ]
     generators = "PkgConfigDeps", "MesonToolchain"
-    exports_sources = "meson.build", "include/*", "test/*"
+    exports_sources = "meson.build", "include/*", "test/*", "bench/*"
     implements = ["auto_header_only"]
 
     def layout(self):
@@ -5,10 +5,35 @@
 #ifndef BOUNDED_PRIORITY_DEQUE_H
 #define BOUNDED_PRIORITY_DEQUE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
 #include <vector>
-
-#ifdef ENABLE_DEBUG
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <bit>
+#include <compare>
+#include <type_traits>
+#include <utility>
+#include <concepts>
+#include <limits>
+#include <iterator>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <future>
+#include <exception>
 #include <stdexcept>
+#include <ranges>
+#include <memory_resource>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
 #endif
 
 /**
@@ -38,7 +63,7 @@ class has_comparison_operator {
     static std::false_type check(...);
 
 public:
-    static constexpr bool value = decltype(check(std::declval<T*>()))::value;
+    static constexpr bool value = decltype(check(std::declval<std::remove_reference_t<T>*>()))::value;
 };
 
 template <typename T>
@@ -82,446 +107,4291 @@ public:
 };
 
 /**
- * @class BoundedPriorityDequeBase
- * @brief Base class for implementing a bounded priority deque.
+ * @struct ExactCapacity
+ * @brief Default capacity policy, the physical buffer holds exactly k slots.
  *
- * This class provides the basic functionalities of a bounded deque with methods for
- * pushing, popping, and accessing elements while maintaining a defined capacity.
+ * Indices wrap with a modulo of k, keeping the memory footprint minimal.
+ */
+struct ExactCapacity {
+    static constexpr size_t physicalSize(size_t k) { return k; }
+    static constexpr size_t wrap(size_t index, size_t physical) { return index % physical; }
+};
+
+/**
+ * @struct Pow2Capacity
+ * @brief Capacity policy rounding the physical buffer up to a power of two.
  *
- * @tparam K Type of the key.
- * @tparam V Type of the value.
+ * Indices wrap with a bit mask instead of an integer division, which removes the division from every
+ * binary search probe and index step. The logical bound reported by capacity() is still exactly k,
+ * at the cost of at most k - 1 unused slots.
  */
-template<typename K, typename V>
-class BoundedPriorityDequeBase {
-protected:
-    std::vector<BoundingPair<K, V>> _buffer;
-    size_t _k, _size = 0, _head = 0, _tail = 0;
+struct Pow2Capacity {
+    static constexpr size_t physicalSize(size_t k) { return k == 0 ? 0 : std::bit_ceil(k); }
+    static constexpr size_t wrap(size_t index, size_t physical) { return index & (physical - 1); }
+};
+
+/**
+ * @class SlotArrayBase
+ * @brief Relocation primitives shared by the raw slot arrays.
+ *
+ * A relocation move constructs the element into a raw slot and destroys the source, leaving the source raw.
+ * Trivially copyable types are relocated with a single memmove, except during constant evaluation.
+ *
+ * @tparam Derived The slot array, providing slot(index).
+ * @tparam T The slot type.
+ */
+template<typename Derived, typename T>
+class SlotArrayBase {
+    [[nodiscard]] constexpr T* at(size_t index) { return static_cast<Derived&>(*this).slot(index); }
 
+public:
     /**
-     * Compares two keys.
-     *
-     * @param a The first key.
-     * @param b The second key.
-     * @return True if a is considered less than b in a min-oriented deque, or more in a max-oriented deque.
+     * @brief constructs an element in a raw slot.
      */
-    virtual bool compare(K a, K b) const = 0;
+    template<typename... Args>
+    constexpr void construct(size_t index, Args&&... args) { std::construct_at(at(index), std::forward<Args>(args)...); }
 
     /**
-     * @brief Provides fast access to the next index of a given insertion position.
-     *
-     * @param current The index queried for next index
-     * @return The next index with circular wrap-around
+     * @brief constructs an element in a raw slot from the result of a callable, eliding the move of a prvalue.
      */
-    [[nodiscard]] size_t nextIndex(size_t current) const { return (current + 1) % _k; }
+    template<typename Make>
+    constexpr void constructFrom(size_t index, Make&& make) {
+        if consteval {
+            std::construct_at(at(index), std::forward<Make>(make)());
+        } else {
+            ::new (static_cast<void*>(at(index))) T(std::forward<Make>(make)());
+        }
+    }
 
     /**
-     * @brief Provides fast access to the previous index of a given insertion position.
-     *
-     * @param current The index queried for previous index
-     * @return The previous index with circular wrap-around
+     * @brief destroys the element in a slot, leaving it raw.
      */
-    [[nodiscard]] size_t prevIndex(size_t current) const { return (current + _k - 1) % _k; }
+    constexpr void destroy(size_t index) { std::destroy_at(at(index)); }
 
     /**
-     * @brief Efficiently locates the optimal insertion index.
-     *
-     * Performs binary insertion search and locates insertion index in O(log n) time,
-     * adapted for a circular buffer with modulo arithmetic. No handling of duplicate values.
-     *
-     * @param target The element to be inserted.
-     * @return The optimal insertion index for the targeted insertion element.
+     * @brief Relocates a single element into a raw slot.
      */
-    size_t binarySearch(const BoundingPair<K, V>& target) const {
-        size_t start = 0;
-        auto end = _size;
-        while (start != end) {
-            size_t mid = start + (end - start) / 2;
-            if (compare(_buffer[(_head + mid) % _k].key, target.key)) start = mid + 1;
-            else end = mid;
-        }
-        return (_head + start) % _k;
-    }
+    constexpr void relocate(size_t from, size_t to) { relocateTo(from, from + 1, static_cast<Derived&>(*this), to); }
 
     /**
-     * @brief Inserts an element into the _buffer
-     *
-     * This is a utility method to allow shared insertion logic between the public push method
-     * and the operator+=() code, the latter of which needed a way to terminate the loop without
-     * running redundant capacity checks, so this function is essentially protection free insertion (think
-     * overwriting elements in the circular buffer), popping from the bottom if capacity is to be exceeded
-     * must be handled by the programmer in this case.
-     *
-     * @param element
+     * @brief Relocates [first, last) towards lower indices, the destination range starting at destination.
      */
-    void insert(const BoundingPair<K, V>& element) {
-        if (_size == 0) {
-            _buffer[0] = element;
-            _head = 0;
-            _tail = 0;
-            _size = 1;
-            return;
-        }
-
-        auto index = binarySearch(element);
-        if (index == nextIndex(_tail)) {
-            if (index == prevIndex(_head) && compare(element.key, topK())) _head = prevIndex(_head);
-            else _tail = nextIndex(_tail);
-        }
-        else if (index == prevIndex(_head)) _head = prevIndex(_head);
-        else if (_head <= _tail && _head > 0) {
-            std::move(_buffer.begin() + _head, _buffer.begin() + index + 1, _buffer.begin() + _head - 1);
-            --_head;
-        } else {
-            std::move_backward(_buffer.begin() + index, _buffer.begin() + _tail + 1, _buffer.begin() + _tail + 2);
-            ++_tail;
-        }
-
-        _buffer[index] = element;
-        ++_size;
+    constexpr void relocateForward(size_t first, size_t last, size_t destination) {
+        relocateTo(first, last, static_cast<Derived&>(*this), destination);
     }
 
     /**
-     * @brief Internal method with no return val
+     * @brief Relocates [first, last) towards higher indices, the destination range ending at destinationLast.
      */
-    void _popTop() {
-        _head = nextIndex(_head);
-        if (--_size == 0) clear();
+    constexpr void relocateBackward(size_t first, size_t last, size_t destinationLast) {
+        if (first == last) return;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if !consteval {
+                std::memmove(at(destinationLast - (last - first)), at(first), (last - first) * sizeof(T));
+                return;
+            }
+        }
+        while (last != first) {
+            --last;
+            --destinationLast;
+            std::construct_at(at(destinationLast), std::move(*at(last)));
+            std::destroy_at(at(last));
+        }
     }
 
     /**
-     * @brief Internal method with no return val
+     * @brief Relocates [first, last) in order into the raw slots of another array, or down within this one.
      */
-    void _popBottom() {
-        _tail = prevIndex(_tail);
-        if (--_size == 0) clear();
+    constexpr void relocateTo(size_t first, size_t last, Derived& destination, size_t destinationFirst) {
+        if (first == last) return;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if !consteval {
+                std::memmove(destination.slot(destinationFirst), at(first), (last - first) * sizeof(T));
+                return;
+            }
+        }
+        for (; first != last; ++first, ++destinationFirst) {
+            std::construct_at(destination.slot(destinationFirst), std::move(*at(first)));
+            std::destroy_at(at(first));
+        }
     }
+};
 
+/**
+ * @class SlotArray
+ * @brief Fixed-size array of raw slots drawn from an allocator.
+ *
+ * Only allocates memory, slots are constructed and destroyed one at a time. Which slots are alive is tracked
+ * by BoundedPriorityDequeBase, so the array never destroys elements on its own.
+ *
+ * @tparam T The slot type.
+ * @tparam Allocator Allocator for T.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class SlotArray : public SlotArrayBase<SlotArray<T, Allocator>, T> {
 public:
-    /**
-     * @brief Primary constructor with default bounding capacity of zero.
-     *
-     * @param capacity The initially set bounding capacity of the data structure.
-     */
-    explicit BoundedPriorityDequeBase(size_t capacity = 0) : _buffer(capacity), _k(capacity) {}
+    using allocator_type = Allocator;
+    static constexpr bool inline_slots = false;
+    static constexpr size_t max_slots = std::numeric_limits<size_t>::max();
 
-    /**
-     * @brief Get the highest-priority element.
-     *
-     * @return the BoundingPair at the head of the circular buffer.
-     */
-    BoundingPair<K, V> top() const {
-#ifdef ENABLE_DEBUG
-        if (empty()) throw std::runtime_error("Attempted to access top element of empty BoundedPriorityDeque");
-#endif
-        return _buffer[_head];
+private:
+    using traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename traits::pointer, T*>, "SlotArray requires an allocator with raw pointers");
+
+    [[no_unique_address]] Allocator _allocator;
+    T* _data = nullptr;
+    size_t _size = 0;
+
+    constexpr void release() {
+        if (_data != nullptr) traits::deallocate(_allocator, _data, _size);
     }
 
-    /**
-     * @brief Get the lowest-priority element.
-     *
-     * Gets the next element to be pruned from the tail of the data structure.
-     *
-     * @return the BoundingPair at the tail of the circular buffer.
-     */
-    BoundingPair<K, V> bottom() const {
-#ifdef ENABLE_DEBUG
-        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityDeque");
-#endif
-        return _buffer[_tail];
+public:
+    constexpr explicit SlotArray(size_t slots = 0, const Allocator& allocator = Allocator()) : _allocator(allocator), _size(slots) {
+        if (slots > 0) _data = traits::allocate(_allocator, slots);
     }
 
+    SlotArray(const SlotArray&) = delete;
+    SlotArray& operator=(const SlotArray&) = delete;
+
+    constexpr SlotArray(SlotArray&& other) noexcept :
+            _allocator(std::move(other._allocator)), _data(std::exchange(other._data, nullptr)),
+            _size(std::exchange(other._size, 0)) {}
+
+    SlotArray& operator=(SlotArray&&) = delete;
+
+    constexpr ~SlotArray() { release(); }
+
+    [[nodiscard]] constexpr size_t size() const { return _size; }
+    [[nodiscard]] constexpr allocator_type get_allocator() const { return _allocator; }
+    [[nodiscard]] constexpr T* slot(size_t index) { return _data + index; }
+    [[nodiscard]] constexpr const T* slot(size_t index) const { return _data + index; }
+
     /**
-     * @brief Get the key from the highest-priority element.
-     *
-     * Introduced to help with merging checks in operator+=, but useful for checking the top of the dequeues
-     * key if an optimization threshold is trying to be achieved.
-     *
-     * @return the lowest-priority elements key.
+     * @return True if adopt() can take over the memory of other.
      */
-    [[nodiscard]] K topK() const {
-#ifdef ENABLE_DEBUG
-        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityDeque");
-#endif
-        return _buffer[_head].key;
+    [[nodiscard]] constexpr bool canAdopt(const SlotArray& other) const {
+        return traits::propagate_on_container_move_assignment::value || _allocator == other._allocator;
     }
 
     /**
-     * @brief Get the key from the lowest-priority element.
-     *
-     * Effective for comparing against the bottom element without the overhead of passing the full BoundingPair<K, V>.
-     *
-     * @return the lowest-priority elements key.
+     * @brief Releases this memory and takes over the memory of other, which is left empty.
      */
-    [[nodiscard]] K bottomK() const {
-#ifdef ENABLE_DEBUG
-        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityDeque");
-#endif
-        return _buffer[_tail].key;
+    constexpr void adopt(SlotArray& other) noexcept {
+        release();
+        if constexpr (traits::propagate_on_container_move_assignment::value) _allocator = std::move(other._allocator);
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
     }
 
-    /**
-     * @brief constructs a BoundingPair<K, V> element and inserts it.
-     *
-     * @param key The bounding key value
-     * @param value The data held by the bounding pair.
-     */
-    void emplace(K key, const V& value) {
-        if (_size == _k) {
-            if (compare(key, _buffer[_tail].key)) _popBottom();
-            else return;
-        }
-        insert({ key, value });
+    constexpr void swap(SlotArray& other) noexcept {
+        if constexpr (traits::propagate_on_container_swap::value) std::swap(_allocator, other._allocator);
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
     }
+};
 
-    /**
-     * @brief Inserts an element into the vector.
-     *
-     * If dequeue is at capacity and the insertion is valid, pops the bottom element.
-     * If straightforward insertion not possible, uses binary search to find the insertion index,
-     * then shifts the elements above or below the insertion index to make room for the item.
-     *
-     * @param element The element to be inserted.
-     */
-    void push(const BoundingPair<K, V>& element) {
-        if (_size == _k) {
-            if (compare(element.key, _buffer[_tail].key)) _popBottom();
-            else return;
-        }
-        insert(element);
+/**
+ * @class InlineSlotArray
+ * @brief Fixed-size array of N raw slots held inside the object, no allocation at all.
+ *
+ * Copying or moving the array yields fresh raw slots, the owning deque transfers the live elements.
+ *
+ * @tparam T The slot type.
+ * @tparam N The number of slots.
+ */
+template<typename T, size_t N>
+class InlineSlotArray : public SlotArrayBase<InlineSlotArray<T, N>, T> {
+public:
+    using allocator_type = std::allocator<T>;
+    static constexpr bool inline_slots = true;
+    static constexpr size_t max_slots = N;
+
+private:
+    // a single array member keeps pointer arithmetic across slots valid during constant evaluation
+    union Slots {
+        T values[N > 0 ? N : 1];
+
+        constexpr Slots() {}
+        constexpr ~Slots() {}
+    };
+
+    Slots _slots;
+
+public:
+    // checked in every build, the deque would otherwise write past the inline slots
+    constexpr explicit InlineSlotArray(size_t slots = N, const allocator_type& = allocator_type()) {
+        if (slots > N) throw std::runtime_error("Capacity exceeds the inline storage of StaticBoundedPriorityDeque");
     }
 
+    InlineSlotArray(const InlineSlotArray&) = delete;
+    InlineSlotArray& operator=(const InlineSlotArray&) = delete;
+
+    [[nodiscard]] static constexpr size_t size() { return N; }
+    [[nodiscard]] constexpr allocator_type get_allocator() const { return {}; }
+    [[nodiscard]] constexpr T* slot(size_t index) { return _slots.values + index; }
+    [[nodiscard]] constexpr const T* slot(size_t index) const { return _slots.values + index; }
+};
+
+/**
+ * @class InterleavedStorage
+ * @brief Default slot storage, keys and values interleaved as BoundingPair<K, V> in a single array of slots.
+ *
+ * The storage only deals in physical slot indices, the circular bookkeeping lives in BoundedPriorityDequeBase.
+ * Slots start out raw, an element is only constructed when the deque inserts it and destroyed when it leaves.
+ *
+ * @tparam K The key type.
+ * @tparam V The value type.
+ * @tparam Slots The raw slot array holding BoundingPair<K, V>, a SlotArray or InlineSlotArray.
+ */
+template<typename K, typename V, typename Slots = SlotArray<BoundingPair<K, V>>>
+class InterleavedStorage {
+public:
+    using allocator_type = typename Slots::allocator_type;
+    using const_reference = const BoundingPair<K, V>&;
+    static constexpr bool inline_slots = Slots::inline_slots;
+    static constexpr size_t max_slots = Slots::max_slots;
+    static constexpr bool trivial_destroy = std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<V>;
+
+private:
+    Slots _slots;
+
+public:
+    constexpr explicit InterleavedStorage(size_t slots = 0, const allocator_type& allocator = allocator_type()) :
+            _slots(slots, allocator) {}
+
+    [[nodiscard]] constexpr size_t size() const { return _slots.size(); }
+    [[nodiscard]] constexpr allocator_type get_allocator() const { return _slots.get_allocator(); }
+
+    [[nodiscard]] constexpr const K& key(size_t index) const { return _slots.slot(index)->key; }
+    [[nodiscard]] constexpr K& key(size_t index) { return _slots.slot(index)->key; }
+    [[nodiscard]] constexpr const V& value(size_t index) const { return _slots.slot(index)->value; }
+    [[nodiscard]] constexpr V& value(size_t index) { return _slots.slot(index)->value; }
+    [[nodiscard]] constexpr const_reference element(size_t index) const { return *_slots.slot(index); }
+
     /**
-     * @brief random accessor relative to the top of the deque.
-     *
-     * This accessor has a lot of uses. It primarily exists to facilitate efficient merges
-     * in operator+=() without removing const protections, but also could be useful for random access
-     * to the i-th element offset from the top, ie the 4th highest-priority item in O(1) time.
-     *
-     * @param offsetTop The unsigned long offset from the top element.
-     * @return The BoundingPair<K, V> element offset from the top of deque.
+     * @return The contiguous element array, indexed by physical slot.
      */
-    BoundingPair<K, V> operator[](size_t offsetTop) const {
-        return _buffer[_head <= _tail ? _head + offsetTop : (_head + offsetTop) % _k];
-    }
+    [[nodiscard]] constexpr const BoundingPair<K, V>* data() const { return _slots.slot(0); }
 
     /**
-     * @brief remove the highest-priority element.
-     *
-     * @return The removed highest-priority element.
+     * @brief Rotates the live slots [first, last) so that middle becomes first.
      */
-    BoundingPair<K, V> pop() {
-#ifdef ENABLE_DEBUG
-        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityDeque");
-#endif
-        auto index = _head;
-        _popTop();
-        return _buffer[index];
+    constexpr void rotate(size_t first, size_t middle, size_t last) {
+        std::rotate(_slots.slot(first), _slots.slot(middle), _slots.slot(last));
     }
 
     /**
-     * @brief remove the lowest-priority element.
-     *
-     * @return The removed lowest-priority element.
+     * @brief constructs an element in a raw slot, the value is built in place from the arguments.
      */
-    BoundingPair<K, V> popBottom() {
-#ifdef ENABLE_DEBUG
-        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityDeque");
-#endif
-        auto index = _tail;
-        _popBottom();
-        return _buffer[index];
+    template<typename Key, typename... Args>
+    constexpr void construct(size_t index, Key&& key, Args&&... args) {
+        _slots.constructFrom(index, [&] { return BoundingPair<K, V> { std::forward<Key>(key), V(std::forward<Args>(args)...) }; });
     }
 
-    /**
-     * @brief Merges another BoundedPriorityDeque instance into the calling instance.
-     *
-     * Compares the incoming dequeues next value to the calling dequeues lowest-priority elements key,
-     * terminates search early when the other buffers top element is lower-priority than 'this' bottom element.
-     * Is non-destructive to the incoming dequeues data.
-     *
-     * @param rhs The BoundedPriorityDeque being merged into 'this' dequeue.
-     */
-    void operator+=(const BoundedPriorityDequeBase<K, V>& rhs) {
-        for (size_t i = 0; i < rhs.size(); ++i) {
-            if (_size == _k) {
-                if (compare(rhs[i].key, bottomK())) _popBottom();
-                else return;
-            }
-            insert(rhs[i]);
-        }
+    constexpr void destroy(size_t index) { _slots.destroy(index); }
+    constexpr void relocate(size_t from, size_t to) { _slots.relocate(from, to); }
+    constexpr void relocateSlots(size_t first, size_t last, size_t destination) { _slots.relocateForward(first, last, destination); }
+
+    constexpr void relocateSlotsBackward(size_t first, size_t last, size_t destinationLast) {
+        _slots.relocateBackward(first, last, destinationLast);
     }
 
-    /**
-     * @brief clears and resets the data structure.
-     *
-     * Resets the size and index pointers to there original values. No destructor calls for performance.
-     */
-    void clear() {
-        _head = 0;
-        _tail = 0;
-        _size = 0;
+    constexpr void relocateSlotsTo(size_t first, size_t last, InterleavedStorage& destination, size_t destinationFirst) {
+        _slots.relocateTo(first, last, destination._slots, destinationFirst);
     }
 
-    /**
-     *
-     * @return The vectors logical size.
-     */
-    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] constexpr bool canAdopt(const InterleavedStorage& other) const requires (!inline_slots) {
+        return _slots.canAdopt(other._slots);
+    }
+
+    constexpr void adopt(InterleavedStorage& other) noexcept requires (!inline_slots) { _slots.adopt(other._slots); }
+    constexpr void swap(InterleavedStorage& other) noexcept requires (!inline_slots) { _slots.swap(other._slots); }
+};
+
+/**
+ * @class SplitStorage
+ * @brief Structure-of-arrays slot storage, keys and values kept in parallel arrays of slots.
+ *
+ * Binary search probes only touch the dense key array, so large values no longer cost a cache miss per probe.
+ * Shifts relocate each array as a contiguous block. Element access yields a BoundingPair of references.
+ *
+ * @tparam K The key type.
+ * @tparam V The value type.
+ * @tparam KeySlots The raw slot array holding the keys.
+ * @tparam ValueSlots The raw slot array holding the values.
+ */
+template<typename K, typename V, typename KeySlots = SlotArray<K>, typename ValueSlots = SlotArray<V>>
+class SplitStorage {
+public:
+    using allocator_type = typename KeySlots::allocator_type;
+    using const_reference = BoundingPair<const K&, const V&>;
+    static constexpr bool inline_slots = KeySlots::inline_slots;
+    static constexpr size_t max_slots = KeySlots::max_slots;
+    static constexpr bool trivial_destroy = std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<V>;
+
+private:
+    KeySlots _keys;
+    ValueSlots _values;
+
+public:
+    constexpr explicit SplitStorage(size_t slots = 0, const allocator_type& allocator = allocator_type()) :
+            _keys(slots, allocator), _values(slots, typename ValueSlots::allocator_type(allocator)) {}
+
+    [[nodiscard]] constexpr size_t size() const { return _keys.size(); }
+    [[nodiscard]] constexpr allocator_type get_allocator() const { return _keys.get_allocator(); }
+
+    [[nodiscard]] constexpr const K& key(size_t index) const { return *_keys.slot(index); }
+    [[nodiscard]] constexpr K& key(size_t index) { return *_keys.slot(index); }
+    [[nodiscard]] constexpr const V& value(size_t index) const { return *_values.slot(index); }
+    [[nodiscard]] constexpr V& value(size_t index) { return *_values.slot(index); }
+    [[nodiscard]] constexpr const_reference element(size_t index) const { return { key(index), value(index) }; }
 
     /**
-     *
-     * @return The bounding capacity of the data structure.
+     * @return The contiguous key array, indexed by physical slot.
      */
-    [[nodiscard]] size_t capacity() const { return _k; }
+    [[nodiscard]] constexpr const K* keys() const { return _keys.slot(0); }
 
     /**
-     *
-     * @return True if the dequeue is empty, else False.
+     * @return The contiguous value array, indexed by physical slot.
      */
-    [[nodiscard]] bool empty() const { return _size == 0; }
+    [[nodiscard]] constexpr const V* values() const { return _values.slot(0); }
 
     /**
-     *
-     * @return True if the dequeue is full, else False.
+     * @brief Rotates the live slots [first, last) so that middle becomes first.
      */
-    [[nodiscard]] bool full() const { return _size == _k; }
+    constexpr void rotate(size_t first, size_t middle, size_t last) {
+        std::rotate(_keys.slot(first), _keys.slot(middle), _keys.slot(last));
+        std::rotate(_values.slot(first), _values.slot(middle), _values.slot(last));
+    }
 
     /**
-     * @brief Sets the capacity and restores clean state.
-     *
-     * Updates the capacity, then restores the _head of the _buffer back to index 0
-     * leaving the buffer in a contiguous fresh state. This preserves the integrity
-     * of the higher-priority data when shrinking the buffer.
-     *
-     * @param k The new capacity.
+     * @brief constructs an element in a raw slot, the value is built in place from the arguments.
      */
-    void resize(size_t k) {
-        if (k == 0) return;
+    template<typename Key, typename... Args>
+    constexpr void construct(size_t index, Key&& key, Args&&... args) {
+        _keys.construct(index, std::forward<Key>(key));
+        if constexpr (std::is_nothrow_constructible_v<V, Args&&...>) _values.construct(index, std::forward<Args>(args)...);
+        else {
+            try {
+                _values.construct(index, std::forward<Args>(args)...);
+            } catch (...) {
+                _keys.destroy(index);
+                throw;
+            }
+        }
+    }
 
-        std::vector<BoundingPair<K, V>> newBuffer(k);
+    constexpr void destroy(size_t index) {
+        _keys.destroy(index);
+        _values.destroy(index);
+    }
 
-        if (_head <= _tail) {
-            size_t elementsToCopy = std::min(_size, k);
-            std::move(_buffer.begin() + _head, _buffer.begin() + _head + elementsToCopy, newBuffer.begin());
-            _size = elementsToCopy;
-        } else {
-            size_t topSize = _k - _head;
-            size_t bottomSize = _tail + 1;
-            size_t elementsToCopyTop = std::min(topSize, k);
-            size_t elementsToCopyBottom = std::min(bottomSize, k - elementsToCopyTop);
+    constexpr void relocate(size_t from, size_t to) {
+        _keys.relocate(from, to);
+        _values.relocate(from, to);
+    }
 
-            std::move(_buffer.begin() + _head, _buffer.begin() + _head + elementsToCopyTop, newBuffer.begin());
-            std::move(_buffer.begin(), _buffer.begin() + elementsToCopyBottom, newBuffer.begin() + elementsToCopyTop);
+    constexpr void relocateSlots(size_t first, size_t last, size_t destination) {
+        _keys.relocateForward(first, last, destination);
+        _values.relocateForward(first, last, destination);
+    }
 
-            _size = elementsToCopyTop + elementsToCopyBottom;
-        }
+    constexpr void relocateSlotsBackward(size_t first, size_t last, size_t destinationLast) {
+        _keys.relocateBackward(first, last, destinationLast);
+        _values.relocateBackward(first, last, destinationLast);
+    }
 
-        _buffer.swap(newBuffer);
-        _k = k;
+    constexpr void relocateSlotsTo(size_t first, size_t last, SplitStorage& destination, size_t destinationFirst) {
+        _keys.relocateTo(first, last, destination._keys, destinationFirst);
+        _values.relocateTo(first, last, destination._values, destinationFirst);
+    }
+
+    [[nodiscard]] constexpr bool canAdopt(const SplitStorage& other) const requires (!inline_slots) {
+        return _keys.canAdopt(other._keys) && _values.canAdopt(other._values);
+    }
+
+    constexpr void adopt(SplitStorage& other) noexcept requires (!inline_slots) {
+        _keys.adopt(other._keys);
+        _values.adopt(other._values);
+    }
+
+    constexpr void swap(SplitStorage& other) noexcept requires (!inline_slots) {
+        _keys.swap(other._keys);
+        _values.swap(other._values);
+    }
+};
+
+/**
+ * @struct SlabEntry
+ * @brief A circular buffer entry of SlabStorage, the key and the slab slot holding its value.
+ */
+template<typename K>
+struct SlabEntry {
+    K key;
+    size_t slot;
+};
+
+/**
+ * @class SlabStorage
+ * @brief Indirect slot storage, the circular buffer holds (key, slab slot) entries and the values sit in a
+ * stable side slab.
+ *
+ * Shifts relocate the small entries only, so their cost no longer grows with sizeof(V), and a value never
+ * moves once constructed. Destroying an element recycles its slab slot through a freelist. Slab slots are
+ * handed out in order until the freelist has entries, so construction stays O(1) at any capacity.
+ *
+ * @tparam K The key type.
+ * @tparam V The value type.
+ * @tparam EntrySlots The raw slot array holding SlabEntry<K>.
+ * @tparam ValueSlots The raw slot array holding the values.
+ * @tparam FreeSlots The raw slot array holding the freelist of slab slots.
+ */
+template<typename K, typename V, typename EntrySlots = SlotArray<SlabEntry<K>>, typename ValueSlots = SlotArray<V>,
+         typename FreeSlots = SlotArray<size_t>>
+class SlabStorage {
+public:
+    using allocator_type = typename EntrySlots::allocator_type;
+    using const_reference = BoundingPair<const K&, const V&>;
+    static constexpr bool inline_slots = EntrySlots::inline_slots;
+    static constexpr size_t max_slots = EntrySlots::max_slots;
+    // destroy() also returns the slab slot to the freelist, so it can never be skipped
+    static constexpr bool trivial_destroy = false;
+
+private:
+    EntrySlots _entries;
+    ValueSlots _values;
+    FreeSlots _free;
+    size_t _freeCount = 0, _fresh = 0;
+
+    /**
+     * @return A raw slab slot, recycled from the freelist when possible.
+     */
+    [[nodiscard]] size_t acquire() { return _freeCount > 0 ? *_free.slot(--_freeCount) : _fresh++; }
+
+    /**
+     * @brief Returns a raw slab slot to the freelist.
+     */
+    void release(size_t slot) { _free.construct(_freeCount++, slot); }
+
+public:
+    explicit SlabStorage(size_t slots = 0, const allocator_type& allocator = allocator_type()) :
+            _entries(slots, allocator), _values(slots, typename ValueSlots::allocator_type(allocator)),
+            _free(slots, typename FreeSlots::allocator_type(allocator)) {}
+
+    SlabStorage(SlabStorage&& other) noexcept :
+            _entries(std::move(other._entries)), _values(std::move(other._values)), _free(std::move(other._free)),
+            _freeCount(std::exchange(other._freeCount, 0)), _fresh(std::exchange(other._fresh, 0)) {}
+
+    [[nodiscard]] size_t size() const { return _entries.size(); }
+    [[nodiscard]] allocator_type get_allocator() const { return _entries.get_allocator(); }
+
+    [[nodiscard]] const K& key(size_t index) const { return _entries.slot(index)->key; }
+    [[nodiscard]] K& key(size_t index) { return _entries.slot(index)->key; }
+    [[nodiscard]] const V& value(size_t index) const { return *_values.slot(_entries.slot(index)->slot); }
+    [[nodiscard]] V& value(size_t index) { return *_values.slot(_entries.slot(index)->slot); }
+    [[nodiscard]] const_reference element(size_t index) const { return { key(index), value(index) }; }
+
+    /**
+     * @brief Rotates the live entries [first, last) so that middle becomes first, the values stay put.
+     */
+    void rotate(size_t first, size_t middle, size_t last) {
+        std::rotate(_entries.slot(first), _entries.slot(middle), _entries.slot(last));
+    }
+
+    /**
+     * @brief constructs an element in a raw entry, the value is built in place in a free slab slot.
+     */
+    template<typename Key, typename... Args>
+    void construct(size_t index, Key&& key, Args&&... args) {
+        auto slot = acquire();
+        if constexpr (std::is_nothrow_constructible_v<V, Args&&...>) _values.construct(slot, std::forward<Args>(args)...);
+        else {
+            try {
+                _values.construct(slot, std::forward<Args>(args)...);
+            } catch (...) {
+                release(slot);
+                throw;
+            }
+        }
+        _entries.construct(index, std::forward<Key>(key), slot);
+    }
+
+    void destroy(size_t index) {
+        auto slot = _entries.slot(index)->slot;
+        _values.destroy(slot);
+        _entries.destroy(index);
+        release(slot);
+    }
+
+    void relocate(size_t from, size_t to) { _entries.relocate(from, to); }
+    void relocateSlots(size_t first, size_t last, size_t destination) { _entries.relocateForward(first, last, destination); }
+
+    void relocateSlotsBackward(size_t first, size_t last, size_t destinationLast) {
+        _entries.relocateBackward(first, last, destinationLast);
+    }
+
+    /**
+     * @brief Relocates the elements [first, last) into another storage, moving each value into its slab.
+     */
+    void relocateSlotsTo(size_t first, size_t last, SlabStorage& destination, size_t destinationFirst) {
+        for (; first != last; ++first, ++destinationFirst) {
+            auto& entry = *_entries.slot(first);
+            auto slot = destination.acquire();
+            destination._values.construct(slot, std::move(*_values.slot(entry.slot)));
+            destination._entries.construct(destinationFirst, std::move(entry.key), slot);
+            destroy(first);
+        }
+    }
+
+    [[nodiscard]] bool canAdopt(const SlabStorage& other) const requires (!inline_slots) {
+        return _entries.canAdopt(other._entries) && _values.canAdopt(other._values) && _free.canAdopt(other._free);
+    }
+
+    void adopt(SlabStorage& other) noexcept requires (!inline_slots) {
+        _entries.adopt(other._entries);
+        _values.adopt(other._values);
+        _free.adopt(other._free);
+        _freeCount = std::exchange(other._freeCount, 0);
+        _fresh = std::exchange(other._fresh, 0);
+    }
+
+    void swap(SlabStorage& other) noexcept requires (!inline_slots) {
+        _entries.swap(other._entries);
+        _values.swap(other._values);
+        _free.swap(other._free);
+        std::swap(_freeCount, other._freeCount);
+        std::swap(_fresh, other._fresh);
+    }
+};
+
+/**
+ * @brief Interleaved storage with N slots held inline, see InlineSlotArray.
+ */
+template<typename K, typename V, size_t N>
+using InlineInterleavedStorage = InterleavedStorage<K, V, InlineSlotArray<BoundingPair<K, V>, N>>;
+
+/**
+ * @brief Structure-of-arrays storage with N slots held inline, see InlineSlotArray.
+ */
+template<typename K, typename V, size_t N>
+using InlineSplitStorage = SplitStorage<K, V, InlineSlotArray<K, N>, InlineSlotArray<V, N>>;
+
+/**
+ * @struct BasicInterleavedLayout
+ * @brief Layout policy selecting InterleavedStorage with the given allocator.
+ *
+ * @tparam Allocator Any allocator, rebound to the slot type.
+ */
+template<typename Allocator = std::allocator<std::byte>>
+struct BasicInterleavedLayout {
+    template<typename K, typename V>
+    using storage = InterleavedStorage<K, V, SlotArray<BoundingPair<K, V>,
+            typename std::allocator_traits<Allocator>::template rebind_alloc<BoundingPair<K, V>>>>;
+};
+
+/**
+ * @struct BasicSplitLayout
+ * @brief Layout policy selecting the structure-of-arrays SplitStorage with the given allocator.
+ *
+ * Pays off once values are large compared to a cache line, or k is large enough for the search to miss cache.
+ *
+ * @tparam Allocator Any allocator, rebound to the key and value types.
+ */
+template<typename Allocator = std::allocator<std::byte>>
+struct BasicSplitLayout {
+    template<typename K, typename V>
+    using storage = SplitStorage<K, V, SlotArray<K, typename std::allocator_traits<Allocator>::template rebind_alloc<K>>,
+                                 SlotArray<V, typename std::allocator_traits<Allocator>::template rebind_alloc<V>>>;
+};
+
+/**
+ * @struct BasicSlabLayout
+ * @brief Layout policy selecting the indirect SlabStorage with the given allocator.
+ *
+ * Shifts move (key, slot) entries instead of whole elements, which pays off for large values at large k.
+ *
+ * @tparam Allocator Any allocator, rebound to the entry, value and freelist types.
+ */
+template<typename Allocator = std::allocator<std::byte>>
+struct BasicSlabLayout {
+    template<typename K, typename V>
+    using storage = SlabStorage<K, V,
+            SlotArray<SlabEntry<K>, typename std::allocator_traits<Allocator>::template rebind_alloc<SlabEntry<K>>>,
+            SlotArray<V, typename std::allocator_traits<Allocator>::template rebind_alloc<V>>,
+            SlotArray<size_t, typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>>>;
+};
+
+/**
+ * @brief Default layout policy, InterleavedStorage with std::allocator.
+ */
+using InterleavedLayout = BasicInterleavedLayout<>;
+
+/**
+ * @brief Structure-of-arrays layout with std::allocator.
+ */
+using SplitLayout = BasicSplitLayout<>;
+
+/**
+ * @brief Indirect layout keeping the values in a side slab, with std::allocator.
+ */
+using SlabLayout = BasicSlabLayout<>;
+
+/**
+ * @struct InlineInterleavedLayout
+ * @brief Layout policy selecting InlineInterleavedStorage with N slots.
+ */
+template<size_t N>
+struct InlineInterleavedLayout {
+    template<typename K, typename V>
+    using storage = InlineInterleavedStorage<K, V, N>;
+};
+
+/**
+ * @struct InlineSplitLayout
+ * @brief Layout policy selecting InlineSplitStorage with N slots.
+ */
+template<size_t N>
+struct InlineSplitLayout {
+    template<typename K, typename V>
+    using storage = InlineSplitStorage<K, V, N>;
+};
+
+/**
+ * @brief Interleaved layout drawing from a std::pmr::memory_resource, such as a per-query monotonic arena.
+ */
+using PmrInterleavedLayout = BasicInterleavedLayout<std::pmr::polymorphic_allocator<std::byte>>;
+
+/**
+ * @brief Structure-of-arrays layout drawing from a std::pmr::memory_resource.
+ */
+using PmrSplitLayout = BasicSplitLayout<std::pmr::polymorphic_allocator<std::byte>>;
+
+/**
+ * @brief Indirect slab layout drawing from a std::pmr::memory_resource.
+ */
+using PmrSlabLayout = BasicSlabLayout<std::pmr::polymorphic_allocator<std::byte>>;
+
+/**
+ * @struct BinarySearch
+ * @brief Default search policy, a classic lower-bound binary search.
+ *
+ * Each probe branches on the comparison, which is cheapest while the key range fits in cache and the
+ * branch predictor still learns something from the access pattern.
+ */
+struct BinarySearch {
+    /**
+     * @brief Deques bounded to at most this many elements insert with a linear scan from the tail instead.
+     */
+    static constexpr size_t linearLimit = 32;
+
+    /**
+     * @param count Number of keys in the sorted range.
+     * @param key The key being located.
+     * @param keyAt Accessor returning the key at an offset into the range.
+     * @param comp The comparator.
+     * @return The number of keys that have a higher priority than key.
+     */
+    template<typename K, typename KeyAt, typename Compare>
+    static constexpr size_t lowerBound(size_t count, const K& key, const KeyAt& keyAt, const Compare& comp) {
+        size_t start = 0;
+        while (start != count) {
+            size_t mid = start + (count - start) / 2;
+            if (comp(keyAt(mid), key)) start = mid + 1;
+            else count = mid;
+        }
+        return start;
+    }
+};
+
+/**
+ * @struct BranchlessSearch
+ * @brief Search policy for large k, a branchless lower bound with software prefetching.
+ *
+ * The range halves on every probe with a conditional add instead of a branch, so a random key costs a fixed
+ * log2(n) iterations without mispredictions. Both candidates for the probe after next are prefetched, hiding
+ * most of the cache misses once the keys outgrow L1.
+ */
+struct BranchlessSearch {
+    /**
+     * @brief Deques bounded to at most this many elements insert with a linear scan from the tail instead.
+     */
+    static constexpr size_t linearLimit = 32;
+
+    /**
+     * @param count Number of keys in the sorted range.
+     * @param key The key being located.
+     * @param keyAt Accessor returning the key at an offset into the range.
+     * @param comp The comparator.
+     * @return The number of keys that have a higher priority than key.
+     */
+    template<typename K, typename KeyAt, typename Compare>
+    static constexpr size_t lowerBound(size_t count, const K& key, const KeyAt& keyAt, const Compare& comp) {
+        if (count == 0) return 0;
+        size_t base = 0;
+        while (count > 1) {
+            auto half = count / 2;
+#if defined(__GNUC__)
+            if !consteval {
+                __builtin_prefetch(&keyAt(base + half / 2));
+                __builtin_prefetch(&keyAt(base + half + half / 2));
+            }
+#endif
+            base += static_cast<size_t>(comp(keyAt(base + half), key)) * half;
+            count -= half;
+        }
+        return base + static_cast<size_t>(comp(keyAt(base), key));
+    }
+};
+
+/**
+ * @struct LifoTies
+ * @brief Default tie policy, a pushed key is placed ahead of the keys it equals.
+ *
+ * Placement among equal keys follows the push order in reverse, merges and range pushes keep the keys
+ * already in the deque first.
+ */
+struct LifoTies {
+    static constexpr bool stable = false;
+};
+
+/**
+ * @struct StableTies
+ * @brief Tie policy placing a pushed key behind the keys it equals, an upper bound instead of a lower bound.
+ *
+ * Together with the rejection of keys equal to the bottom of a full deque, the contents are always the first
+ * k elements of a stable sort of everything pushed, independent of the capacity and search policies. This
+ * includes pushRange() and merges, where the deque being merged into counts as pushed first. For results
+ * that are also independent of the push order, break ties in the key itself, for example a std::pair of
+ * distance and id under std::less<>, which costs no extra comparison pass.
+ */
+struct StableTies {
+    static constexpr bool stable = true;
+};
+
+/**
+ * @brief Detects comparators that order arithmetic keys with the builtin < or > operators.
+ *
+ * Such comparators can be evaluated over many keys at once with vector compares.
+ *
+ * @tparam Compare The comparator type.
+ * @tparam K The key type.
+ */
+template<typename Compare, typename K>
+inline constexpr bool is_builtin_ordering_v = std::is_arithmetic_v<K> &&
+        (std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>> ||
+         std::is_same_v<Compare, std::greater<K>> || std::is_same_v<Compare, std::greater<>>);
+
+/**
+ * @brief Counts the keys that have a higher priority than the given key.
+ *
+ * Over sorted keys this is the lower-bound insertion offset, computed without a single data-dependent
+ * branch. float, double, int32 and int64 keys use AVX-512, AVX2 or SSE2 compares with the counts
+ * accumulated in vector lanes, whichever the translation unit is compiled for. Everything else
+ * (including NEON targets) relies on the compiler vectorizing the scalar loop.
+ *
+ * @param keys Contiguous keys.
+ * @param count Number of keys.
+ * @param key The key being ranked.
+ * @param comp The comparator, one satisfying is_builtin_ordering_v.
+ * @return The number of keys k for which comp(k, key) holds.
+ */
+template<typename K, typename Compare>
+size_t countHigherPriority(const K* keys, size_t count, const K& key, const Compare& comp) {
+    size_t i = 0, rank = 0;
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__)
+    // compare masks are all ones per matching lane, subtracting them accumulates the count in vector lanes
+    [[maybe_unused]] constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+    [[maybe_unused]] constexpr bool isInt32 = std::is_integral_v<K> && std::is_signed_v<K> && sizeof(K) == 4;
+    [[maybe_unused]] constexpr bool isInt64 = std::is_integral_v<K> && std::is_signed_v<K> && sizeof(K) == 8;
+#endif
+#if defined(__AVX512F__)
+    [[maybe_unused]] constexpr int predicate = ascending ? _CMP_LT_OQ : _CMP_GT_OQ;
+    if constexpr (std::is_same_v<K, double> || isInt64) {
+        auto acc = _mm512_setzero_si512(), one = _mm512_set1_epi64(1);
+        for (; i + 8 <= count; i += 8) {
+            __mmask8 mask;
+            if constexpr (std::is_same_v<K, double>) {
+                mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(keys + i), _mm512_set1_pd(key), predicate);
+            } else {
+                auto values = _mm512_loadu_si512(keys + i), target = _mm512_set1_epi64(static_cast<long long>(key));
+                mask = ascending ? _mm512_cmplt_epi64_mask(values, target) : _mm512_cmpgt_epi64_mask(values, target);
+            }
+            acc = _mm512_mask_add_epi64(acc, mask, acc, one);
+        }
+        alignas(64) long long lanes[8];
+        _mm512_store_si512(lanes, acc);
+        for (auto lane : lanes) rank += static_cast<size_t>(lane);
+    } else if constexpr (std::is_same_v<K, float> || isInt32) {
+        auto acc = _mm512_setzero_si512(), one = _mm512_set1_epi32(1);
+        for (; i + 16 <= count; i += 16) {
+            __mmask16 mask;
+            if constexpr (std::is_same_v<K, float>) {
+                mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(keys + i), _mm512_set1_ps(key), predicate);
+            } else {
+                auto values = _mm512_loadu_si512(keys + i), target = _mm512_set1_epi32(static_cast<int>(key));
+                mask = ascending ? _mm512_cmplt_epi32_mask(values, target) : _mm512_cmpgt_epi32_mask(values, target);
+            }
+            acc = _mm512_mask_add_epi32(acc, mask, acc, one);
+        }
+        alignas(64) int lanes[16];
+        _mm512_store_si512(lanes, acc);
+        for (auto lane : lanes) rank += static_cast<size_t>(lane);
+    }
+#elif defined(__AVX2__)
+    [[maybe_unused]] constexpr int predicate = ascending ? _CMP_LT_OQ : _CMP_GT_OQ;
+    if constexpr (std::is_same_v<K, double> || isInt64) {
+        auto acc = _mm256_setzero_si256();
+        for (; i + 4 <= count; i += 4) {
+            __m256i mask;
+            if constexpr (std::is_same_v<K, double>) {
+                mask = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(keys + i), _mm256_set1_pd(key), predicate));
+            } else {
+                auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+                auto target = _mm256_set1_epi64x(static_cast<long long>(key));
+                mask = ascending ? _mm256_cmpgt_epi64(target, values) : _mm256_cmpgt_epi64(values, target);
+            }
+            acc = _mm256_sub_epi64(acc, mask);
+        }
+        alignas(32) long long lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        rank = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    } else if constexpr (std::is_same_v<K, float> || isInt32) {
+        auto acc = _mm256_setzero_si256();
+        for (; i + 8 <= count; i += 8) {
+            __m256i mask;
+            if constexpr (std::is_same_v<K, float>) {
+                mask = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(keys + i), _mm256_set1_ps(key), predicate));
+            } else {
+                auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+                auto target = _mm256_set1_epi32(static_cast<int>(key));
+                mask = ascending ? _mm256_cmpgt_epi32(target, values) : _mm256_cmpgt_epi32(values, target);
+            }
+            acc = _mm256_sub_epi32(acc, mask);
+        }
+        alignas(32) int lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        for (auto lane : lanes) rank += static_cast<size_t>(lane);
+    }
+#elif defined(__SSE2__)
+    if constexpr (std::is_same_v<K, double>) {
+        auto acc = _mm_setzero_si128();
+        for (; i + 2 <= count; i += 2) {
+            auto values = _mm_loadu_pd(keys + i), target = _mm_set1_pd(key);
+            acc = _mm_sub_epi64(acc, _mm_castpd_si128(ascending ? _mm_cmplt_pd(values, target) : _mm_cmpgt_pd(values, target)));
+        }
+        alignas(16) long long lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        rank = static_cast<size_t>(lanes[0] + lanes[1]);
+    } else if constexpr (std::is_same_v<K, float> || isInt32) {
+        auto acc = _mm_setzero_si128();
+        for (; i + 4 <= count; i += 4) {
+            __m128i mask;
+            if constexpr (std::is_same_v<K, float>) {
+                auto values = _mm_loadu_ps(keys + i), target = _mm_set1_ps(key);
+                mask = _mm_castps_si128(ascending ? _mm_cmplt_ps(values, target) : _mm_cmpgt_ps(values, target));
+            } else {
+                auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+                auto target = _mm_set1_epi32(static_cast<int>(key));
+                mask = ascending ? _mm_cmpgt_epi32(target, values) : _mm_cmpgt_epi32(values, target);
+            }
+            acc = _mm_sub_epi32(acc, mask);
+        }
+        alignas(16) int lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        for (auto lane : lanes) rank += static_cast<size_t>(lane);
+    }
+#endif
+    for (; i < count; ++i) rank += static_cast<size_t>(comp(keys[i], key));
+    return rank;
+}
+
+/**
+ * @struct DequeStats
+ * @brief Hot-path counters of a BoundedPriorityDequeBase, kept only when ENABLE_DEQUE_STATS is defined.
+ *
+ * Meant for choosing the capacity, capacity policy and backend of a call site from a representative run.
+ * Without the macro the deque holds no counters and every update compiles to nothing.
+ */
+struct DequeStats {
+    size_t accepted = 0;        ///< Pushes that passed the capacity check.
+    size_t rejected = 0;        ///< Pushes turned away by a full deque, including those skipped by pushRange().
+    size_t topInserts = 0;      ///< Insertions at the head, no search and no shift.
+    size_t bottomInserts = 0;   ///< Insertions at the tail, no search and no shift.
+    size_t searchedInserts = 0; ///< Insertions between the ends.
+    size_t shifted = 0;         ///< Elements relocated by one slot to open an insertion slot.
+    size_t probes = 0;          ///< Keys compared while locating insertion offsets.
+    size_t mergeEarlyExits = 0; ///< Merges that returned without taking any element.
+    size_t reallocations = 0;   ///< Buffer reallocations by reserve() and resize().
+};
+
+/**
+ * @struct DequeSnapshot
+ * @brief Binary format written by BoundedPriorityDequeBase::serialize(), read back by deserialize() and
+ * BoundedPriorityDequeView.
+ *
+ * A record is a 32-byte Header, the keys in priority order starting at offset 32, then the values starting
+ * at the next multiple of alignof(V). The record is padded to a multiple of alignment, so records written
+ * back to back into an aligned region, a file mapped into memory for instance, stay aligned and can be
+ * viewed in place. Integers and elements are stored in native byte order and layout, a snapshot is meant
+ * to be reloaded by the same build that wrote it.
+ */
+struct DequeSnapshot {
+    static constexpr uint32_t magic = 0x51445042;
+    static constexpr uint32_t version = 1;
+    static constexpr size_t alignment = 16;
+
+    struct Header {
+        uint32_t magic, version, keyBytes, valueBytes;
+        uint64_t capacity, size;
+    };
+
+    static_assert(sizeof(Header) == 32);
+
+    template<typename K, typename V>
+    static constexpr bool supports = std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V> &&
+            std::is_default_constructible_v<K> && std::is_default_constructible_v<V> &&
+            alignof(K) <= alignment && alignof(V) <= alignment;
+
+    [[nodiscard]] static constexpr size_t alignUp(size_t bytes, size_t to) { return (bytes + to - 1) / to * to; }
+
+    /**
+     * @return The offset of the value array in a record holding size elements.
+     */
+    template<typename K, typename V>
+    [[nodiscard]] static constexpr size_t valueOffset(size_t size) {
+        return alignUp(sizeof(Header) + size * sizeof(K), alignof(V));
+    }
+
+    /**
+     * @return The total size of a record holding size elements, padding included.
+     */
+    template<typename K, typename V>
+    [[nodiscard]] static constexpr size_t bytes(size_t size) {
+        return alignUp(valueOffset<K, V>(size) + size * sizeof(V), alignment);
+    }
+
+    /**
+     * @brief Reads and validates the header at the start of a record.
+     *
+     * Records usually come from files, so the checks run in every build, not only under ENABLE_DEBUG.
+     * A record that passes them is large enough for all of its elements.
+     */
+    template<typename K, typename V>
+    [[nodiscard]] static Header header(std::span<const std::byte> record) {
+        if (record.size() < sizeof(Header)) throw std::runtime_error("Truncated BoundedPriorityDeque snapshot");
+        Header header;
+        std::memcpy(&header, record.data(), sizeof(Header));
+        if (header.magic != magic || header.version != version || header.keyBytes != sizeof(K) ||
+            header.valueBytes != sizeof(V) || header.size > header.capacity ||
+            header.capacity > std::numeric_limits<size_t>::max()) {
+            throw std::runtime_error("Malformed BoundedPriorityDeque snapshot");
+        }
+        // bounding the size by the record first keeps bytes() from overflowing on a corrupt size
+        if (header.size > record.size() / (sizeof(K) + sizeof(V)) || record.size() < bytes<K, V>(header.size)) {
+            throw std::runtime_error("Truncated BoundedPriorityDeque snapshot");
+        }
+        return header;
+    }
+};
+
+/**
+ * @class BoundedPriorityDequeBase
+ * @brief Base class for implementing a bounded priority deque.
+ *
+ * This class provides the basic functionalities of a bounded deque with methods for
+ * pushing, popping, and accessing elements while maintaining a defined capacity.
+ *
+ * The comparator is a template parameter rather than a virtual hook; every comparison is resolved
+ * statically and inlined into the search and insertion paths, and the object carries no vtable pointer.
+ *
+ * @tparam K Type of the key.
+ * @tparam V Type of the value.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @tparam CapacityPolicy Physical buffer sizing and index wrapping, ExactCapacity or Pow2Capacity.
+ * @tparam Layout Slot storage layout, InterleavedLayout or SplitLayout.
+ * @tparam SearchPolicy Insertion offset search beyond rankSearchLimit, BinarySearch or BranchlessSearch.
+ * @tparam TiePolicy Placement of equal keys, LifoTies or StableTies.
+ */
+template<typename K, typename V, typename Compare = std::less<K>, typename CapacityPolicy = ExactCapacity,
+         typename Layout = InterleavedLayout, typename SearchPolicy = BinarySearch, typename TiePolicy = LifoTies>
+class BoundedPriorityDequeBase {
+public:
+    using Base = BoundedPriorityDequeBase;
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = BoundingPair<K, V>;
+    using key_compare = Compare;
+    using Storage = typename Layout::template storage<K, V>;
+    using allocator_type = typename Storage::allocator_type;
+    using const_reference = typename Storage::const_reference;
+
+    /**
+     * @brief True when keys are contiguous and ordered by a builtin comparison, enabling rankSearch().
+     */
+    static constexpr bool rankSearchable = is_builtin_ordering_v<Compare, K> &&
+            requires(const Storage& storage) { { storage.keys() } -> std::same_as<const K*>; };
+
+    /**
+     * @brief Deques up to this size are searched with rankSearch() rather than binarySearch().
+     */
+    static constexpr size_t rankSearchLimit = 64;
+
+    /**
+     * @class const_iterator
+     * @brief Random access iterator over the elements in priority order, top first.
+     *
+     * Holds an offset from the top, so the iterator stays valid while elements are only read. Stepping
+     * never wraps an index, dereferencing maps the offset to its slot with a single conditional subtraction.
+     * Under a split layout the reference is a BoundingPair of references, which is also the value_type.
+     */
+    class const_iterator {
+        const BoundedPriorityDequeBase* _deque = nullptr;
+        size_t _offset = 0;
+
+        friend BoundedPriorityDequeBase;
+
+        constexpr const_iterator(const BoundedPriorityDequeBase* deque, size_t offset) : _deque(deque), _offset(offset) {}
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cvref_t<const_reference>;
+        using difference_type = std::ptrdiff_t;
+        using reference = const_reference;
+
+        const_iterator() = default;
+
+        constexpr reference operator*() const { return (*_deque)[_offset]; }
+        constexpr reference operator[](difference_type n) const { return (*_deque)[_offset + n]; }
+
+        constexpr const value_type* operator->() const requires std::is_lvalue_reference_v<reference> { return &**this; }
+
+        constexpr const_iterator& operator++() { ++_offset; return *this; }
+        constexpr const_iterator& operator--() { --_offset; return *this; }
+        constexpr const_iterator operator++(int) { auto copy = *this; ++_offset; return copy; }
+        constexpr const_iterator operator--(int) { auto copy = *this; --_offset; return copy; }
+        constexpr const_iterator& operator+=(difference_type n) { _offset += n; return *this; }
+        constexpr const_iterator& operator-=(difference_type n) { _offset -= n; return *this; }
+
+        friend constexpr const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+        friend constexpr const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+        friend constexpr const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+
+        friend constexpr difference_type operator-(const const_iterator& a, const const_iterator& b) {
+            return static_cast<difference_type>(a._offset) - static_cast<difference_type>(b._offset);
+        }
+
+        friend constexpr bool operator==(const const_iterator& a, const const_iterator& b) { return a._offset == b._offset; }
+        friend constexpr auto operator<=>(const const_iterator& a, const const_iterator& b) { return a._offset <=> b._offset; }
+    };
+
+    using iterator = const_iterator;
+
+protected:
+    Storage _buffer;
+    size_t _k, _size = 0, _head = 0, _tail = 0;
+    [[no_unique_address]] Compare comparator;
+#ifdef ENABLE_DEQUE_STATS
+    mutable DequeStats _stats;
+#endif
+
+    /**
+     * @brief Adds to one of the DequeStats counters, a no-op unless ENABLE_DEQUE_STATS is defined and outside of
+     * constant evaluation, where the mutable counters cannot be written.
+     */
+    constexpr void count([[maybe_unused]] size_t DequeStats::* counter, [[maybe_unused]] size_t n = 1) const {
+#ifdef ENABLE_DEQUE_STATS
+        if !consteval {
+            _stats.*counter += n;
+        }
+#endif
+    }
+
+    /**
+     * Compares two keys.
+     *
+     * @param a The first key.
+     * @param b The second key.
+     * @return True if a is considered less than b in a min-oriented deque, or more in a max-oriented deque.
+     */
+    [[nodiscard]] constexpr bool compare(const K& a, const K& b) const { return comparator(a, b); }
+
+    /**
+     * @brief Decides whether a key already in the deque stays ahead of a key being inserted.
+     *
+     * @param resident A key in the deque.
+     * @param key The key of the element to be inserted.
+     * @return True if resident has a higher-priority than key, or is equal to it under StableTies.
+     */
+    [[nodiscard]] constexpr bool staysAhead(const K& resident, const K& key) const {
+        if constexpr (TiePolicy::stable) return !comparator(key, resident);
+        else return comparator(resident, key);
+    }
+
+    /**
+     * @brief Wraps a physical index into the circular buffer as dictated by the capacity policy.
+     *
+     * @param index A physical index less than twice the buffer size.
+     * @return The wrapped physical index.
+     */
+    [[nodiscard]] constexpr size_t wrap(size_t index) const { return CapacityPolicy::wrap(index, _buffer.size()); }
+
+    /**
+     * @brief Provides fast access to the next index of a given insertion position.
+     *
+     * A single step only ever wraps at the end of the buffer, so a comparison replaces the division of wrap().
+     *
+     * @param current The index queried for next index
+     * @return The next index with circular wrap-around
+     */
+    [[nodiscard]] constexpr size_t nextIndex(size_t current) const { return current + 1 == _buffer.size() ? 0 : current + 1; }
+
+    /**
+     * @brief Provides fast access to the previous index of a given insertion position.
+     *
+     * @param current The index queried for previous index
+     * @return The previous index with circular wrap-around
+     */
+    [[nodiscard]] constexpr size_t prevIndex(size_t current) const { return current == 0 ? _buffer.size() - 1 : current - 1; }
+
+    /**
+     * @brief Maps an offset from the top to its physical index with a conditional subtraction.
+     *
+     * Cheaper than wrap() under ExactCapacity, where wrap() costs an integer division.
+     *
+     * @param offset An offset from the top, less than the buffer size.
+     * @return The physical index of the element at offset.
+     */
+    [[nodiscard]] constexpr size_t physicalIndex(size_t offset) const {
+        auto index = _head + offset;
+        return index >= _buffer.size() ? index - _buffer.size() : index;
+    }
+
+    /**
+     * @brief Efficiently locates the optimal insertion offset.
+     *
+     * Locates the insertion offset in O(log n) time with the SearchPolicy. The circular buffer covers at most
+     * two contiguous runs of physical slots, a single comparison against the first slot of the second run
+     * picks the run holding the offset, so the probes themselves never wrap. Equal keys are placed as
+     * dictated by the TiePolicy.
+     *
+     * @param key The key of the element to be inserted.
+     * @return The insertion offset relative to the top of the deque, in the range [0, size()].
+     */
+    constexpr size_t binarySearch(const K& key) const {
+        auto upper = std::min(_size, _buffer.size() - _head);
+        auto run = [this](size_t first) {
+            return [this, first](size_t offset) -> const K& { return _buffer.key(first + offset); };
+        };
+        auto precedes = [this](const K& resident, const K& k) {
+            count(&DequeStats::probes);
+            return staysAhead(resident, k);
+        };
+        if (upper < _size && staysAhead(_buffer.key(0), key)) {
+            return upper + SearchPolicy::lowerBound(_size - upper, key, run(0), precedes);
+        }
+        return SearchPolicy::lowerBound(upper, key, run(_head), precedes);
+    }
+
+    /**
+     * @brief Branchless insertion offset search over the contiguous key array.
+     *
+     * Counts the higher-priority keys in the one or two contiguous runs covered by the circular buffer,
+     * replacing the mispredicting probes of binarySearch() with a handful of vector compares. Under StableTies
+     * the keys ranked behind the key are counted with the reversed comparison instead.
+     *
+     * @param key The key of the element to be inserted.
+     * @return The insertion offset relative to the top of the deque, in the range [0, size()].
+     */
+    constexpr size_t rankSearch(const K& key) const requires rankSearchable {
+        count(&DequeStats::probes, _size);
+        auto keys = _buffer.keys();
+        auto upper = std::min(_size, _buffer.size() - _head);
+        auto count = [&](const auto& comp) {
+            return countHigherPriority(keys + _head, upper, key, comp) + countHigherPriority(keys, _size - upper, key, comp);
+        };
+        if constexpr (TiePolicy::stable) {
+            constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+            return _size - count(std::conditional_t<ascending, std::greater<K>, std::less<K>>());
+        } else return count(comparator);
+    }
+
+    /**
+     * @brief Locates the insertion offset with the best search available for this deque.
+     *
+     * @param key The key of the element to be inserted.
+     * @return The insertion offset relative to the top of the deque, in the range [0, size()].
+     */
+    constexpr size_t search(const K& key) const {
+        if constexpr (rankSearchable) {
+            if !consteval {
+                if (_size <= rankSearchLimit) return rankSearch(key);
+            }
+        }
+        return binarySearch(key);
+    }
+
+    /**
+     * @brief Shifts the elements from offset to the bottom one slot towards the tail.
+     *
+     * Requires a free slot after _tail, the vacated slot is left raw at the physical index of offset.
+     *
+     * @param offset The offset from the top of the first element to be shifted.
+     */
+    constexpr void shiftTailward(size_t offset) {
+        count(&DequeStats::shifted, _size - offset);
+        auto first = wrap(_head + offset), last = _buffer.size() - 1;
+        if (first <= _tail && _tail < last) {
+            _buffer.relocateSlotsBackward(first, _tail + 1, _tail + 2);
+        } else {
+            if (first > _tail) _buffer.relocateSlotsBackward(0, _tail + 1, _tail + 2);
+            _buffer.relocate(last, 0);
+            _buffer.relocateSlotsBackward(first, last, last + 1);
+        }
+        _tail = nextIndex(_tail);
+    }
+
+    /**
+     * @brief Shifts the elements above offset one slot towards the head.
+     *
+     * Requires a free slot before _head, the vacated slot is left raw at the physical index of offset - 1.
+     *
+     * @param offset The offset from the top of the first element that is not shifted, at least 1.
+     */
+    constexpr void shiftHeadward(size_t offset) {
+        count(&DequeStats::shifted, offset);
+        auto last = wrap(_head + offset - 1), end = _buffer.size() - 1;
+        if (_head <= last && _head > 0) {
+            _buffer.relocateSlots(_head, last + 1, _head - 1);
+        } else {
+            if (_head > last) _buffer.relocateSlots(_head, end + 1, _head - 1);
+            _buffer.relocate(0, end);
+            _buffer.relocateSlots(1, last + 1, 0);
+        }
+        _head = prevIndex(_head);
+    }
+
+    /**
+     * @brief Opens the sorted slot for a key in the _buffer
+     *
+     * This is a utility method to allow shared insertion logic between the public push and emplace methods,
+     * which run the capacity checks themselves, so this function is essentially protection free insertion (think
+     * overwriting elements in the circular buffer), popping from the bottom if capacity is to be exceeded
+     * must be handled by the programmer in this case.
+     *
+     * The key is first tested against the bottom and top keys, insertions at either end skip the search and
+     * only move the _head or _tail index, otherwise the shorter side of the buffer is shifted to open the
+     * insertion slot.
+     *
+     * @param key The key of the element about to be constructed.
+     * @return The physical index of the opened raw slot, already counted in _size.
+     */
+    constexpr size_t openSlot(const K& key) {
+        if (_size == 0) {
+            _head = 0;
+            _tail = 0;
+            _size = 1;
+            return 0;
+        }
+
+        if constexpr (Storage::max_slots <= SearchPolicy::linearLimit) return openSlotLinear(key);
+        else if (_k <= SearchPolicy::linearLimit) return openSlotLinear(key);
+
+        // most accepted keys land at one of the ends, test those before paying for a search
+        size_t offset;
+        if (staysAhead(_buffer.key(_tail), key)) offset = _size;
+        else if (!staysAhead(_buffer.key(_head), key)) offset = 0;
+        else offset = search(key);
+
+        size_t index;
+        if (offset == _size) {
+            count(&DequeStats::bottomInserts);
+            index = _tail = nextIndex(_tail);
+        } else if (offset == 0) {
+            count(&DequeStats::topInserts);
+            index = _head = prevIndex(_head);
+        } else if (offset < _size - offset) {
+            count(&DequeStats::searchedInserts);
+            index = wrap(_head + offset - 1);
+            shiftHeadward(offset);
+        } else {
+            count(&DequeStats::searchedInserts);
+            index = wrap(_head + offset);
+            shiftTailward(offset);
+        }
+
+        ++_size;
+        return index;
+    }
+
+    /**
+     * @brief openSlot() for small deques, a single scan from the tail that shifts as it goes.
+     *
+     * Every key behind the new one is relocated a slot tailward as soon as it is compared, so locating and
+     * opening the slot take one pass with predictable branches and no index division. Keys going to the top
+     * still only move the _head index. Chosen by openSlot() when the capacity is at most
+     * SearchPolicy::linearLimit, at compile time for inline storage of that size.
+     *
+     * @param key The key of the element about to be constructed, the deque is not empty.
+     * @return The physical index of the opened raw slot, already counted in _size.
+     */
+    constexpr size_t openSlotLinear(const K& key) {
+        ++_size;
+        if (!staysAhead(_buffer.key(_head), key)) {
+            count(&DequeStats::topInserts);
+            return _head = prevIndex(_head);
+        }
+
+        auto last = _buffer.size() - 1;
+        auto hole = _tail == last ? 0 : _tail + 1, index = _tail, tail = hole;
+        _tail = hole;
+        while (!staysAhead(_buffer.key(index), key)) {
+            count(&DequeStats::probes);
+            count(&DequeStats::shifted);
+            _buffer.relocate(index, hole);
+            hole = index;
+            index = index == 0 ? last : index - 1;
+        }
+        count(hole == tail ? &DequeStats::bottomInserts : &DequeStats::searchedInserts);
+        return hole;
+    }
+
+    /**
+     * @brief Constructs an admitted element in the slot opened for its key, see openSlot().
+     *
+     * The value is built directly in the slot when that cannot throw. Otherwise it is built first and moved
+     * in, so a throwing constructor leaves the deque untouched rather than holding a raw slot.
+     *
+     * @param key The key, copied or moved.
+     * @param args The arguments forwarded to the value constructor.
+     */
+    template<typename Key, typename... Args>
+    constexpr void place(Key&& key, Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<V, Args&&...>) {
+            auto index = openSlot(key);
+            _buffer.construct(index, std::forward<Key>(key), std::forward<Args>(args)...);
+        } else {
+            V value(std::forward<Args>(args)...);
+            auto index = openSlot(key);
+            _buffer.construct(index, std::forward<Key>(key), std::move(value));
+        }
+    }
+
+    /**
+     * @brief Destroys the live elements, leaving every slot raw.
+     */
+    constexpr void destroyElements() {
+        if constexpr (!Storage::trivial_destroy) {
+            for (size_t i = 0, index = _head; i < _size; ++i, index = nextIndex(index)) _buffer.destroy(index);
+        }
+    }
+
+    /**
+     * @brief Relocates the live elements of other into the raw slots of this buffer at the same physical
+     * indices, leaving other empty.
+     *
+     * @param other A deque with the same buffer size as this one.
+     */
+    constexpr void relocateFrom(BoundedPriorityDequeBase& other) {
+        auto upper = std::min(other._size, other._buffer.size() - other._head);
+        other._buffer.relocateSlotsTo(other._head, other._head + upper, _buffer, other._head);
+        other._buffer.relocateSlotsTo(0, other._size - upper, _buffer, 0);
+        _k = other._k;
+        _size = other._size;
+        _head = other._head;
+        _tail = other._tail;
+        other._size = 0;
+        other.clear();
+    }
+
+    /**
+     * @brief Runs the capacity check ahead of an insertion.
+     *
+     * If the dequeue is at capacity and the key outranks the bottom element, pops the bottom element.
+     *
+     * @param key The key of the candidate element.
+     * @return True if the candidate may be inserted, false if it is rejected.
+     */
+    [[nodiscard]] constexpr bool admit(const K& key) {
+        if (_size == _k) {
+            if (_k > 0 && compare(key, _buffer.key(_tail))) _popBottom();
+            else {
+                count(&DequeStats::rejected);
+                return false;
+            }
+        }
+        count(&DequeStats::accepted);
+        return true;
+    }
+
+    /**
+     * @brief Shared linear merge behind both operator+=() overloads.
+     *
+     * The output occupies offsets [0, n) from _head. The elements of 'this' pushed out by the bound are
+     * destroyed first, then writing backwards from offset n - 1 always lands on a raw slot, never on an
+     * element of 'this' that has not been consumed yet, so no scratch storage is needed.
+     *
+     * @param rhs The deque being merged, its values are moved out if it is an rvalue.
+     */
+    template<typename Deque>
+    constexpr void merge(Deque&& rhs) {
+        if (rhs._size == 0 || _k == 0 || (_size == _k && !compare(rhs._buffer.key(rhs._head), _buffer.key(_tail)))) {
+            count(&DequeStats::mergeEarlyExits);
+            return;
+        }
+
+        auto lhsAt = [this](size_t offset) -> const K& { return _buffer.key(wrap(_head + offset)); };
+        auto rhsAt = [&rhs](size_t offset) -> const K& { return rhs._buffer.key(rhs.wrap(rhs._head + offset)); };
+
+        auto n = std::min(_k, _size + rhs._size);
+        size_t lo = n > rhs._size ? n - rhs._size : 0, hi = std::min(_size, n);
+        while (lo < hi) {
+            auto mid = lo + (hi - lo) / 2;
+            if (!compare(rhsAt(n - mid - 1), lhsAt(mid))) lo = mid + 1;
+            else hi = mid;
+        }
+
+        auto i = lo, j = n - lo;
+        if (j == 0) {
+            count(&DequeStats::mergeEarlyExits);
+            return;
+        }
+        if constexpr (!Storage::trivial_destroy) {
+            for (auto offset = lo; offset < _size; ++offset) _buffer.destroy(wrap(_head + offset));
+        }
+
+        // walk physical indices backwards with a conditional wrap, keeping divisions out of the loop
+        auto back = [](size_t index, size_t physical) { return index == 0 ? physical - 1 : index - 1; };
+        auto out = wrap(_head + n), lhs = wrap(_head + i), src = rhs.wrap(rhs._head + j);
+        while (j > 0) {
+            out = back(out, _buffer.size());
+            auto from = back(src, rhs._buffer.size());
+            if (i > 0 && compare(rhs._buffer.key(from), _buffer.key(back(lhs, _buffer.size())))) {
+                lhs = back(lhs, _buffer.size());
+                _buffer.relocate(lhs, out);
+                --i;
+            } else {
+                if constexpr (std::is_rvalue_reference_v<Deque&&>) {
+                    _buffer.construct(out, std::move(rhs._buffer.key(from)), std::move(rhs._buffer.value(from)));
+                } else _buffer.construct(out, rhs._buffer.key(from), rhs._buffer.value(from));
+                src = from;
+                --j;
+            }
+        }
+
+        _size = n;
+        if (_size > 0) _tail = wrap(_head + _size - 1);
+    }
+
+    /**
+     * @brief Internal method with no return val
+     */
+    constexpr void _popTop() {
+        _buffer.destroy(_head);
+        _head = nextIndex(_head);
+        if (--_size == 0) clear();
+    }
+
+    /**
+     * @brief Internal method with no return val
+     */
+    constexpr void _popBottom() {
+        _buffer.destroy(_tail);
+        _tail = prevIndex(_tail);
+        if (--_size == 0) clear();
+    }
+
+public:
+    /**
+     * @brief Primary constructor with default bounding capacity of zero.
+     *
+     * Only allocates the buffer, no key or value is constructed until an element is inserted.
+     *
+     * @param capacity The initially set bounding capacity of the data structure.
+     * @param comp The comparator instance, only relevant for stateful comparators.
+     */
+    constexpr explicit BoundedPriorityDequeBase(size_t capacity = 0, Compare comp = Compare()) :
+            _buffer(CapacityPolicy::physicalSize(capacity)), _k(capacity), comparator(comp) {}
+
+    /**
+     * @brief Allocator-extended constructor, the buffer and all internal scratch storage use the allocator.
+     *
+     * With a std::pmr layout this takes a memory resource directly, e.g. a per-query monotonic arena.
+     *
+     * @param capacity The initially set bounding capacity of the data structure.
+     * @param comp The comparator instance, only relevant for stateful comparators.
+     * @param allocator The allocator, copied for every later reallocation by resize().
+     */
+    constexpr BoundedPriorityDequeBase(size_t capacity, Compare comp, const allocator_type& allocator) :
+            _buffer(CapacityPolicy::physicalSize(capacity), allocator), _k(capacity), comparator(comp) {}
+
+    /**
+     * @brief Allocator-extended constructor with a default constructed comparator.
+     *
+     * @param capacity The initially set bounding capacity of the data structure.
+     * @param allocator The allocator, copied for every later reallocation by resize().
+     */
+    constexpr BoundedPriorityDequeBase(size_t capacity, const allocator_type& allocator) :
+            BoundedPriorityDequeBase(capacity, Compare(), allocator) {}
+
+    /**
+     * @brief Range constructor, keeps the top-k of the given elements, see pushRange().
+     *
+     * @param capacity The initially set bounding capacity of the data structure.
+     * @param first The first element of the range.
+     * @param last The end of the range.
+     * @param comp The comparator instance, only relevant for stateful comparators.
+     */
+    template<std::input_iterator InputIt>
+    constexpr BoundedPriorityDequeBase(size_t capacity, InputIt first, InputIt last, Compare comp = Compare()) :
+            BoundedPriorityDequeBase(capacity, comp) {
+        pushRange(first, last);
+    }
+
+    /**
+     * @brief Copy constructor, copies the live elements only.
+     *
+     * @param other The deque to copy.
+     */
+    constexpr BoundedPriorityDequeBase(const BoundedPriorityDequeBase& other) :
+            _buffer(other._buffer.size(),
+                    std::allocator_traits<allocator_type>::select_on_container_copy_construction(other.get_allocator())),
+            _k(other._k), _head(other._head), _tail(other._tail), comparator(other.comparator) {
+        try {
+            for (; _size < other._size; ++_size) {
+                auto index = wrap(_head + _size);
+                _buffer.construct(index, other._buffer.key(index), other._buffer.value(index));
+            }
+        } catch (...) {
+            destroyElements();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Move constructor, takes over the buffer of other, which is left with a capacity of zero.
+     *
+     * @param other The deque to move from.
+     */
+    constexpr BoundedPriorityDequeBase(BoundedPriorityDequeBase&& other) noexcept requires (!Storage::inline_slots) :
+            _buffer(std::move(other._buffer)), _k(std::exchange(other._k, 0)), _size(std::exchange(other._size, 0)),
+            _head(std::exchange(other._head, 0)), _tail(std::exchange(other._tail, 0)), comparator(other.comparator) {}
+
+    /**
+     * @brief Move constructor for inline storage, relocates the live elements, other is left empty.
+     *
+     * @param other The deque to move from.
+     */
+    constexpr BoundedPriorityDequeBase(BoundedPriorityDequeBase&& other)
+            noexcept(std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>)
+            requires Storage::inline_slots : _buffer(other._buffer.size()), _k(0), comparator(other.comparator) {
+        relocateFrom(other);
+    }
+
+    /**
+     * @brief Copy assignment, copies the live elements of other.
+     *
+     * @param other The deque to copy.
+     * @return This deque.
+     */
+    constexpr BoundedPriorityDequeBase& operator=(const BoundedPriorityDequeBase& other) {
+        if (this != &other) *this = BoundedPriorityDequeBase(other);
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment, takes over the buffer of other when the allocators allow it and relocates the
+     * live elements into a buffer from this allocator otherwise.
+     *
+     * @param other The deque to move from.
+     * @return This deque.
+     */
+    constexpr BoundedPriorityDequeBase& operator=(BoundedPriorityDequeBase&& other) {
+        if (this == &other) return *this;
+        clear();
+        comparator = other.comparator;
+        if constexpr (!Storage::inline_slots) {
+            if (_buffer.canAdopt(other._buffer)) {
+                _buffer.adopt(other._buffer);
+                _k = std::exchange(other._k, 0);
+                _size = std::exchange(other._size, 0);
+                _head = std::exchange(other._head, 0);
+                _tail = std::exchange(other._tail, 0);
+                return *this;
+            }
+            Storage fresh(other._buffer.size(), get_allocator());
+            _buffer.adopt(fresh);
+        }
+        relocateFrom(other);
+        return *this;
+    }
+
+    /**
+     * @brief Destroys the live elements, raw slots are left alone.
+     */
+    constexpr ~BoundedPriorityDequeBase() { destroyElements(); }
+
+    /**
+     * @brief Get the highest-priority element.
+     *
+     * @return A reference to the BoundingPair at the head of the circular buffer.
+     */
+    constexpr const_reference top() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access top element of empty BoundedPriorityDeque");
+#endif
+        return _buffer.element(_head);
+    }
+
+    /**
+     * @brief Get the lowest-priority element.
+     *
+     * Gets the next element to be pruned from the tail of the data structure.
+     *
+     * @return A reference to the BoundingPair at the tail of the circular buffer.
+     */
+    constexpr const_reference bottom() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityDeque");
+#endif
+        return _buffer.element(_tail);
+    }
+
+    /**
+     * @brief Get the key from the highest-priority element.
+     *
+     * Introduced to help with merging checks in operator+=, but useful for checking the top of the dequeues
+     * key if an optimization threshold is trying to be achieved.
+     *
+     * @return the lowest-priority elements key.
+     */
+    [[nodiscard]] constexpr K topK() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityDeque");
+#endif
+        return _buffer.key(_head);
+    }
+
+    /**
+     * @brief Get the key from the lowest-priority element.
+     *
+     * Effective for comparing against the bottom element without the overhead of passing the full BoundingPair<K, V>.
+     *
+     * @return the lowest-priority elements key.
+     */
+    [[nodiscard]] constexpr K bottomK() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityDeque");
+#endif
+        return _buffer.key(_tail);
+    }
+
+    /**
+     * @brief The key a candidate must outrank to be accepted, for early-out pruning.
+     *
+     * The bottom key once the deque is full, before that the lowest-priority value of K (infinity or the
+     * numeric limit), so 'compare(candidate, threshold())' decides acceptance without a separate full() check.
+     * A zero capacity deque reports the highest-priority value instead, rejecting everything.
+     *
+     * @return The current acceptance threshold.
+     */
+    [[nodiscard]] constexpr K threshold() const requires is_builtin_ordering_v<Compare, K> {
+        constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+        using limits = std::numeric_limits<K>;
+        constexpr K highest = limits::has_infinity ? limits::infinity() : limits::max();
+        constexpr K lowest = limits::has_infinity ? -limits::infinity() : limits::lowest();
+        if (_size == _k) return _k == 0 ? (ascending ? lowest : highest) : _buffer.key(_tail);
+        return ascending ? highest : lowest;
+    }
+
+    /**
+     * @brief constructs a BoundingPair<K, V> element and inserts it.
+     *
+     * @param key The bounding key value
+     * @param value The data held by the bounding pair.
+     */
+    constexpr void emplace(const K& key, const V& value) {
+        if (admit(key)) place(key, value);
+    }
+
+    /**
+     * @brief constructs a BoundingPair<K, V> element and inserts it, moving the value into place.
+     *
+     * @param key The bounding key value
+     * @param value The data held by the bounding pair.
+     */
+    constexpr void emplace(const K& key, V&& value) {
+        if (admit(key)) place(key, std::move(value));
+    }
+
+    /**
+     * @brief constructs the value from the given arguments in the slot chosen for the key.
+     *
+     * The value is only built once the capacity check has passed, rejected candidates never construct it,
+     * and is built directly in its slot when its constructor cannot throw.
+     *
+     * @param key The bounding key value
+     * @param args The arguments forwarded to the value constructor.
+     */
+    template<typename... Args>
+    constexpr void emplace(const K& key, Args&&... args) {
+        if (admit(key)) place(key, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Inserts an element into the vector.
+     *
+     * If dequeue is at capacity and the insertion is valid, pops the bottom element.
+     * If straightforward insertion not possible, uses binary search to find the insertion index,
+     * then shifts the elements above or below the insertion index to make room for the item.
+     *
+     * @param element The element to be inserted.
+     */
+    constexpr void push(const BoundingPair<K, V>& element) {
+        if (admit(element.key)) place(element.key, element.value);
+    }
+
+    /**
+     * @brief Inserts an element into the vector, moving it into place.
+     *
+     * @param element The element to be inserted.
+     */
+    constexpr void push(BoundingPair<K, V>&& element) {
+        if (admit(element.key)) place(std::move(element.key), std::move(element.value));
+    }
+
+    /**
+     * @brief Inserts a range of elements at once, keeping the top-k.
+     *
+     * A single selection pass copies the candidates that outrank the current bottom element into a scratch
+     * buffer, which is cut back to its best k with nth_element whenever it reaches 2k, tightening the bound
+     * for the rest of the pass. The survivors are sorted and merged in linearly as if by operator+=(), so
+     * N elements cost O(N + k log k) rather than N searches and shifts. On equal keys the elements already
+     * in the deque come first. Within the range equal keys keep their order under StableTies, so the result
+     * matches pushing the elements one by one, otherwise their relative order is unspecified.
+     *
+     * @param first The first element of the range, anything exposing key and value members.
+     * @param last The end of the range.
+     */
+    template<std::input_iterator InputIt>
+    constexpr void pushRange(InputIt first, InputIt last) {
+        if (_k == 0) return;
+
+        struct Candidate {
+            BoundingPair<K, V> element;
+            size_t order;
+        };
+        std::vector<Candidate, typename std::allocator_traits<allocator_type>::template rebind_alloc<Candidate>>
+                candidates(get_allocator());
+        auto byPriority = [this](const Candidate& a, const Candidate& b) {
+            if constexpr (TiePolicy::stable) {
+                if (compare(b.element.key, a.element.key)) return false;
+                return compare(a.element.key, b.element.key) || a.order < b.order;
+            } else return compare(a.element.key, b.element.key);
+        };
+        auto trim = [&] {
+            std::nth_element(candidates.begin(), candidates.begin() + (_k - 1), candidates.end(), byPriority);
+            candidates.erase(candidates.begin() + _k, candidates.end());
+        };
+
+        bool trimmed = false;
+        for (size_t order = 0; first != last; ++first, ++order) {
+            const auto& element = *first;
+            if ((full() && !compare(element.key, _buffer.key(_tail))) ||
+                (trimmed && !compare(element.key, candidates[_k - 1].element.key))) {
+                count(&DequeStats::rejected);
+                continue;
+            }
+            candidates.push_back({ { element.key, element.value }, order });
+            if (candidates.size() == 2 * _k) {
+                trim();
+                trimmed = true;
+            }
+        }
+
+        if (candidates.size() > _k) trim();
+        std::sort(candidates.begin(), candidates.end(), byPriority);
+
+        BoundedPriorityDequeBase sorted(candidates.size(), comparator, get_allocator());
+        for (auto& candidate : candidates) {
+            sorted._buffer.construct(sorted._size, std::move(candidate.element.key), std::move(candidate.element.value));
+            ++sorted._size;
+        }
+        if (sorted._size > 0) sorted._tail = sorted._size - 1;
+        merge(std::move(sorted));
+    }
+
+    /**
+     * @brief random accessor relative to the top of the deque.
+     *
+     * This accessor has a lot of uses. It primarily exists to facilitate efficient merges
+     * in operator+=() without removing const protections, but also could be useful for random access
+     * to the i-th element offset from the top, ie the 4th highest-priority item in O(1) time.
+     *
+     * @param offsetTop The unsigned long offset from the top element.
+     * @return A reference to the BoundingPair<K, V> element offset from the top of deque.
+     */
+    constexpr const_reference operator[](size_t offsetTop) const {
+        return _buffer.element(physicalIndex(offsetTop));
+    }
+
+    /**
+     * @return An iterator to the highest-priority element.
+     */
+    [[nodiscard]] constexpr const_iterator begin() const { return { this, 0 }; }
+
+    /**
+     * @return An iterator past the lowest-priority element.
+     */
+    [[nodiscard]] constexpr const_iterator end() const { return { this, _size }; }
+
+    /**
+     * @brief Views the elements in place as at most two contiguous runs, in priority order.
+     *
+     * The first span covers the elements from _head to the end of the buffer, the second the elements
+     * wrapped around to the start of the buffer and is empty unless the deque wraps. The spans are
+     * invalidated by any modification, call linearize() first to get everything in the first span.
+     * Requires an interleaved layout, where the elements themselves are contiguous.
+     *
+     * @return The two runs, top run first.
+     */
+    [[nodiscard]] constexpr std::array<std::span<const value_type>, 2> as_spans() const
+            requires requires(const Storage& storage) { { storage.data() } -> std::same_as<const value_type*>; } {
+        if (_size == 0) return {};
+        auto upper = std::min(_size, _buffer.size() - _head);
+        return { std::span<const value_type>(_buffer.data() + _head, upper),
+                 std::span<const value_type>(_buffer.data(), _size - upper) };
+    }
+
+    /**
+     * @brief Makes the elements contiguous in place, with the highest-priority element at index 0.
+     *
+     * A deque that does not wrap is relocated down to the start of the buffer. A wrapped one first closes
+     * the gap between its two runs, then rotates them into order, no scratch buffer is allocated.
+     * Afterwards as_spans() returns everything in its first span. O(size()).
+     */
+    constexpr void linearize() {
+        if (_head == 0) return;
+        if (_size == 0) {
+            clear();
+            return;
+        }
+
+        auto upper = std::min(_size, _buffer.size() - _head), wrapped = _size - upper;
+        if (_head != wrapped) _buffer.relocateSlots(_head, _head + upper, wrapped);
+        if (wrapped > 0) _buffer.rotate(0, wrapped, _size);
         _head = 0;
         _tail = _size - 1;
     }
+
+    /**
+     * @return The number of bytes serialize() writes for the current contents, see DequeSnapshot.
+     */
+    [[nodiscard]] size_t serializedSize() const requires DequeSnapshot::supports<K, V> {
+        return DequeSnapshot::bytes<K, V>(_size);
+    }
+
+    /**
+     * @brief Writes the capacity and the elements in priority order as a DequeSnapshot record.
+     *
+     * Keys and values are copied bytewise, a split layout copies each of its runs as one block. Padding is
+     * zeroed, so equal deques produce equal records.
+     *
+     * @param out The destination, at least serializedSize() bytes.
+     * @return The number of bytes written, serializedSize().
+     */
+    size_t serialize(std::span<std::byte> out) const requires DequeSnapshot::supports<K, V> {
+        auto bytes = serializedSize(), valueOffset = DequeSnapshot::valueOffset<K, V>(_size);
+        if (out.size() < bytes) throw std::runtime_error("Snapshot buffer too small for BoundedPriorityDeque");
+        DequeSnapshot::Header header { DequeSnapshot::magic, DequeSnapshot::version, sizeof(K), sizeof(V), _k, _size };
+        std::memcpy(out.data(), &header, sizeof(header));
+
+        auto* keys = out.data() + sizeof(header);
+        auto* values = out.data() + valueOffset;
+        auto keysEnd = sizeof(header) + _size * sizeof(K), valuesEnd = valueOffset + _size * sizeof(V);
+        std::memset(out.data() + keysEnd, 0, valueOffset - keysEnd);
+        std::memset(out.data() + valuesEnd, 0, bytes - valuesEnd);
+
+        if constexpr (requires { _buffer.keys(); _buffer.values(); }) {
+            auto upper = std::min(_size, _buffer.size() - _head);
+            std::memcpy(keys, _buffer.keys() + _head, upper * sizeof(K));
+            std::memcpy(keys + upper * sizeof(K), _buffer.keys(), (_size - upper) * sizeof(K));
+            std::memcpy(values, _buffer.values() + _head, upper * sizeof(V));
+            std::memcpy(values + upper * sizeof(V), _buffer.values(), (_size - upper) * sizeof(V));
+        } else {
+            for (size_t offset = 0, index = _head; offset < _size; ++offset, index = nextIndex(index)) {
+                std::memcpy(keys + offset * sizeof(K), &_buffer.key(index), sizeof(K));
+                std::memcpy(values + offset * sizeof(V), &_buffer.value(index), sizeof(V));
+            }
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Replaces the contents with a DequeSnapshot record, taking over its capacity.
+     *
+     * The elements are already in priority order, so they are placed from the start of the buffer without
+     * any search, O(size()).
+     *
+     * @param record The record, further records may follow it.
+     * @return The number of bytes consumed, the offset of the next record.
+     */
+    size_t deserialize(std::span<const std::byte> record) requires DequeSnapshot::supports<K, V> {
+        auto header = DequeSnapshot::header<K, V>(record);
+        auto size = static_cast<size_t>(header.size);
+        if (header.capacity > Storage::max_slots) {
+            throw std::runtime_error("Snapshot capacity exceeds the inline storage of StaticBoundedPriorityDeque");
+        }
+        clear();
+        if (header.capacity == 0) _k = 0;
+        else resize(static_cast<size_t>(header.capacity));
+
+        const auto* keys = record.data() + sizeof(header);
+        const auto* values = record.data() + DequeSnapshot::valueOffset<K, V>(size);
+        for (size_t index = 0; index < size; ++index) {
+            K key;
+            V value;
+            std::memcpy(&key, keys + index * sizeof(K), sizeof(K));
+            std::memcpy(&value, values + index * sizeof(V), sizeof(V));
+            _buffer.construct(index, key, value);
+        }
+        _size = size;
+        _tail = size == 0 ? 0 : size - 1;
+        return DequeSnapshot::bytes<K, V>(size);
+    }
+
+    /**
+     * @brief remove the highest-priority element.
+     *
+     * The slot is logically freed by the pop, so the element is moved out rather than copied.
+     *
+     * @return The removed highest-priority element.
+     */
+    constexpr BoundingPair<K, V> pop() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityDeque");
+#endif
+        BoundingPair<K, V> element { std::move(_buffer.key(_head)), std::move(_buffer.value(_head)) };
+        _popTop();
+        return element;
+    }
+
+    /**
+     * @brief remove the lowest-priority element.
+     *
+     * The slot is logically freed by the pop, so the element is moved out rather than copied.
+     *
+     * @return The removed lowest-priority element.
+     */
+    constexpr BoundingPair<K, V> popBottom() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityDeque");
+#endif
+        BoundingPair<K, V> element { std::move(_buffer.key(_tail)), std::move(_buffer.value(_tail)) };
+        _popBottom();
+        return element;
+    }
+
+    /**
+     * @brief remove the highest-priority element without returning it.
+     *
+     * Destroys the element and advances the _head index, pair with top() to drain results without touching the
+     * element twice.
+     */
+    constexpr void discardTop() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityDeque");
+#endif
+        _popTop();
+    }
+
+    /**
+     * @brief remove the lowest-priority element without returning it.
+     *
+     * Destroys the element and retreats the _tail index.
+     */
+    constexpr void discardBottom() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityDeque");
+#endif
+        _popBottom();
+    }
+
+    /**
+     * @brief Merges another BoundedPriorityDeque instance into the calling instance.
+     *
+     * Both deques are already sorted, so the merge is linear: a merge-path binary search finds how many
+     * elements of each deque survive the capacity bound, then a single backward two-pointer pass writes
+     * the result in place from the tail. Terminates in O(log k) when the other buffers top element is
+     * lower-priority than 'this' bottom element. On equal keys the elements already in 'this' come first.
+     * Is non-destructive to the incoming dequeues data.
+     *
+     * @param rhs The BoundedPriorityDeque being merged into 'this' dequeue.
+     */
+    constexpr void operator+=(const BoundedPriorityDequeBase& rhs) {
+        if (this == &rhs) {
+            BoundedPriorityDequeBase copy(_k, comparator, get_allocator());
+            copy.merge(rhs);
+            merge(std::move(copy));
+        } else merge(rhs);
+    }
+
+    /**
+     * @brief Merges another BoundedPriorityDeque instance into the calling instance, moving its values.
+     *
+     * Identical to the copying merge, but values taken from rhs are moved rather than copied.
+     * The incoming deque is left empty.
+     *
+     * @param rhs The BoundedPriorityDeque being merged into 'this' dequeue.
+     */
+    constexpr void operator+=(BoundedPriorityDequeBase&& rhs) {
+        if (this == &rhs) return;
+        merge(std::move(rhs));
+        rhs.clear();
+    }
+
+    /**
+     * @brief Collects the top-k elements across any number of deques in a single k-way pass.
+     *
+     * Keeps a small binary heap over the heads of the incoming deques and appends the winner to 'out'
+     * until it holds capacity() elements or the inputs are exhausted, so every element is touched at most
+     * once instead of O(log N) times when folding pairwise with operator+=(). Equal keys are taken in the
+     * order of the deques in the span, making the result independent of the merge order.
+     * The previous contents of 'out' are discarded, the incoming deques are left untouched.
+     *
+     * @param deques The deques to merge, null pointers are skipped. Must not contain 'out'.
+     * @param out The deque receiving the result.
+     */
+    static constexpr void mergeAll(std::span<const BoundedPriorityDequeBase* const> deques, BoundedPriorityDequeBase& out) {
+        out.clear();
+
+        struct Cursor {
+            const BoundedPriorityDequeBase* deque;
+            size_t index, remaining, order;
+
+            [[nodiscard]] const K& key() const { return deque->_buffer.key(index); }
+        };
+
+        std::vector<Cursor, typename std::allocator_traits<allocator_type>::template rebind_alloc<Cursor>>
+                heap(out.get_allocator());
+        heap.reserve(deques.size());
+        for (size_t i = 0; i < deques.size(); ++i) {
+            if (deques[i] != nullptr && !deques[i]->empty()) heap.push_back({ deques[i], deques[i]->_head, deques[i]->_size, i });
+        }
+
+        auto lowerPriority = [&out](const Cursor& a, const Cursor& b) {
+            if (out.compare(b.key(), a.key())) return true;
+            if (out.compare(a.key(), b.key())) return false;
+            return a.order > b.order;
+        };
+        std::make_heap(heap.begin(), heap.end(), lowerPriority);
+
+        while (!heap.empty() && out._size < out._k) {
+            std::pop_heap(heap.begin(), heap.end(), lowerPriority);
+            auto& cursor = heap.back();
+            out._buffer.construct(out._size, cursor.key(), cursor.deque->_buffer.value(cursor.index));
+            ++out._size;
+            if (--cursor.remaining == 0) heap.pop_back();
+            else {
+                if (++cursor.index == cursor.deque->_buffer.size()) cursor.index = 0;
+                std::push_heap(heap.begin(), heap.end(), lowerPriority);
+            }
+        }
+
+        if (out._size > 0) out._tail = out._size - 1;
+    }
+
+    /**
+     * @brief clears and resets the data structure.
+     *
+     * Destroys the live elements and resets the size and index pointers to there original values.
+     * Trivially destructible elements are not visited, leaving clear() O(1).
+     */
+    constexpr void clear() {
+        destroyElements();
+        _head = 0;
+        _tail = 0;
+        _size = 0;
+    }
+
+    /**
+     *
+     * @return A copy of the allocator of the buffer.
+     */
+    [[nodiscard]] constexpr allocator_type get_allocator() const { return _buffer.get_allocator(); }
+
+#ifdef ENABLE_DEQUE_STATS
+    /**
+     * @return The hot-path counters since construction or the last resetStats().
+     */
+    [[nodiscard]] constexpr const DequeStats& stats() const { return _stats; }
+
+    constexpr void resetStats() { _stats = {}; }
+#endif
+
+    /**
+     *
+     * @return The vectors logical size.
+     */
+    [[nodiscard]] constexpr size_t size() const { return _size; }
+
+    /**
+     *
+     * @return The bounding capacity of the data structure.
+     */
+    [[nodiscard]] constexpr size_t capacity() const { return _k; }
+
+    /**
+     *
+     * @return True if the dequeue is empty, else False.
+     */
+    [[nodiscard]] constexpr bool empty() const { return _size == 0; }
+
+    /**
+     *
+     * @return True if the dequeue is full, else False.
+     */
+    [[nodiscard]] constexpr bool full() const { return _size == _k; }
+
+    /**
+     * @brief Preallocates the buffer for capacities up to maxK.
+     *
+     * Only the physical storage grows, the capacity is unchanged. A later resize() to any k up to maxK then
+     * never allocates or moves an element. Reallocating relocates the elements to the start of the buffer.
+     *
+     * @param maxK The largest capacity to be set without a reallocation.
+     */
+    constexpr void reserve(size_t maxK) {
+        if (CapacityPolicy::physicalSize(maxK) > _buffer.size()) reallocate(CapacityPolicy::physicalSize(maxK), _size);
+    }
+
+    /**
+     * @brief Sets the capacity, keeping the highest-priority elements.
+     *
+     * When the buffer already holds the slots for k, see reserve(), only the bound changes: a shrink destroys
+     * the surplus elements from the bottom and nothing is moved or allocated. Otherwise the buffer is
+     * reallocated and the elements are relocated to its start.
+     *
+     * @param k The new capacity.
+     */
+    constexpr void resize(size_t k) {
+        if (k == 0) return;
+
+        if (CapacityPolicy::physicalSize(k) > _buffer.size()) reallocate(CapacityPolicy::physicalSize(k), std::min(_size, k));
+        else if (_size > k) {
+            if constexpr (!Storage::trivial_destroy) {
+                for (auto offset = k; offset < _size; ++offset) _buffer.destroy(wrap(_head + offset));
+            }
+            _size = k;
+            _tail = wrap(_head + _size - 1);
+        }
+        _k = k;
+    }
+
+private:
+    /**
+     * @brief Moves the top elements into a new buffer of the given physical size, starting at index 0.
+     *
+     * @param physical The physical size of the new buffer.
+     * @param keep The number of elements kept, the rest is destroyed.
+     */
+    constexpr void reallocate(size_t physical, size_t keep) {
+        count(&DequeStats::reallocations);
+        Storage newBuffer(physical, _buffer.get_allocator());
+
+        size_t elementsToCopyTop = std::min(keep, _buffer.size() - _head);
+        size_t elementsToCopyBottom = keep - elementsToCopyTop;
+
+        _buffer.relocateSlotsTo(_head, _head + elementsToCopyTop, newBuffer, 0);
+        _buffer.relocateSlotsTo(0, elementsToCopyBottom, newBuffer, elementsToCopyTop);
+        if constexpr (!Storage::trivial_destroy) {
+            for (auto offset = keep; offset < _size; ++offset) _buffer.destroy(wrap(_head + offset));
+        }
+
+        if constexpr (Storage::inline_slots) newBuffer.relocateSlotsTo(0, keep, _buffer, 0);
+        else _buffer.swap(newBuffer);
+        _size = keep;
+        _head = 0;
+        _tail = _size == 0 ? 0 : _size - 1;
+    }
+};
+
+/**
+ * @class BoundedMinPriorityDeque
+ * @brief Lightweight minimum priority dequeue
+ *
+ * This class provides a lightweight minimum priority implement of the base class with an arithmetic key value.
+ *
+ * @tparam K Arithmetic type of the key.
+ * @tparam V Type of the value.
+ * @tparam CapacityPolicy Physical buffer sizing and index wrapping, ExactCapacity or Pow2Capacity.
+ * @tparam Layout Slot storage layout, InterleavedLayout or SplitLayout.
+ * @tparam SearchPolicy Insertion offset search beyond rankSearchLimit, BinarySearch or BranchlessSearch.
+ * @tparam TiePolicy Placement of equal keys, LifoTies or StableTies.
+ */
+template<typename K, typename V, typename CapacityPolicy = ExactCapacity, typename Layout = InterleavedLayout,
+         typename SearchPolicy = BinarySearch, typename TiePolicy = LifoTies>
+class BoundedMinPriorityDeque
+        : public BoundedPriorityDequeBase<K, V, std::less<K>, CapacityPolicy, Layout, SearchPolicy, TiePolicy> {
+public:
+    using Base = BoundedPriorityDequeBase<K, V, std::less<K>, CapacityPolicy, Layout, SearchPolicy, TiePolicy>;
+
+    constexpr explicit BoundedMinPriorityDeque(unsigned int capacity = 0) : Base(capacity) {}
+
+    constexpr BoundedMinPriorityDeque(unsigned int capacity, const typename Base::allocator_type& allocator) : Base(capacity, allocator) {}
+
+    template<std::input_iterator InputIt>
+    constexpr BoundedMinPriorityDeque(unsigned int capacity, InputIt first, InputIt last) : Base(capacity, first, last) {}
+};
+
+/**
+ * @class BoundedMaxPriorityDeque
+ * @brief Lightweight maximum priority dequeue
+ *
+ * This class provides a lightweight maximum priority implement of the base class with an arithmetic key value.
+ *
+ * @tparam K Arithmetic type of the key.
+ * @tparam V Type of the value.
+ * @tparam CapacityPolicy Physical buffer sizing and index wrapping, ExactCapacity or Pow2Capacity.
+ * @tparam Layout Slot storage layout, InterleavedLayout or SplitLayout.
+ * @tparam SearchPolicy Insertion offset search beyond rankSearchLimit, BinarySearch or BranchlessSearch.
+ * @tparam TiePolicy Placement of equal keys, LifoTies or StableTies.
+ */
+template<typename K, typename V, typename CapacityPolicy = ExactCapacity, typename Layout = InterleavedLayout,
+         typename SearchPolicy = BinarySearch, typename TiePolicy = LifoTies>
+class BoundedMaxPriorityDeque
+        : public BoundedPriorityDequeBase<K, V, std::greater<K>, CapacityPolicy, Layout, SearchPolicy, TiePolicy> {
+public:
+    using Base = BoundedPriorityDequeBase<K, V, std::greater<K>, CapacityPolicy, Layout, SearchPolicy, TiePolicy>;
+
+    constexpr explicit BoundedMaxPriorityDeque(unsigned int capacity = 0) : Base(capacity) {}
+
+    constexpr BoundedMaxPriorityDeque(unsigned int capacity, const typename Base::allocator_type& allocator) : Base(capacity, allocator) {}
+
+    template<std::input_iterator InputIt>
+    constexpr BoundedMaxPriorityDeque(unsigned int capacity, InputIt first, InputIt last) : Base(capacity, first, last) {}
+};
+
+/**
+ * @class BoundedPriorityDequeKeyed
+ * @brief Lightweight custom key comparator priority dequeue
+ *
+ * This class provides a lightweight custom-comparator implement of the base class.
+ * This derived class allows for non-standard or non-arithmetic key types via a custom-comparator template argument.
+ * The custom-comparator should be in the form of a function<bool(K a, K b)> comparator which returns
+ * true if 'a' has a higher-priority than 'b'.
+ *
+ * @tparam K Template-comparator compatible key Type.
+ * @tparam V Type of the value.
+ * @tparam CapacityPolicy Physical buffer sizing and index wrapping, ExactCapacity or Pow2Capacity.
+ * @tparam Layout Slot storage layout, InterleavedLayout or SplitLayout.
+ * @tparam SearchPolicy Insertion offset search beyond rankSearchLimit, BinarySearch or BranchlessSearch.
+ * @tparam TiePolicy Placement of equal keys, LifoTies or StableTies.
+ */
+template<typename K, typename V, typename Comparator = std::less<K>, typename CapacityPolicy = ExactCapacity,
+         typename Layout = InterleavedLayout, typename SearchPolicy = BinarySearch, typename TiePolicy = LifoTies>
+class BoundedPriorityDequeKeyed
+        : public BoundedPriorityDequeBase<K, V, Comparator, CapacityPolicy, Layout, SearchPolicy, TiePolicy> {
+public:
+    using Base = BoundedPriorityDequeBase<K, V, Comparator, CapacityPolicy, Layout, SearchPolicy, TiePolicy>;
+
+    constexpr explicit BoundedPriorityDequeKeyed(unsigned int capacity = 0, Comparator comp = Comparator()) :
+            Base(capacity, comp) {}
+
+    constexpr BoundedPriorityDequeKeyed(unsigned int capacity, Comparator comp, const typename Base::allocator_type& allocator) :
+            Base(capacity, comp, allocator) {}
+
+    template<std::input_iterator InputIt>
+    constexpr BoundedPriorityDequeKeyed(unsigned int capacity, InputIt first, InputIt last, Comparator comp = Comparator()) :
+            Base(capacity, first, last, comp) {}
+};
+
+/**
+ * @class BoundedPriorityDeque
+ * @brief Lightweight custom value-based comparator priority dequeue
+ *
+ * This derived class enables comparison on a value objects internal state with a comparator.
+ *
+ * The addition of a comparisonValue() allows for a key to be extracted from the value objects internal structure.
+ *
+ * ex. for double:  [[nodiscard]] double comparisonValue(const Edge& edge) const { return edge.distance; }
+ *
+ * The custom-comparator should be in the form of a function<bool(K a, K b)> comparator which returns
+ * true if 'a' has a higher-priority than 'b'.
+ *
+ * @tparam K Template-comparator compatible key Type.
+ * @tparam V Type of the value.
+ * @tparam CapacityPolicy Physical buffer sizing and index wrapping, ExactCapacity or Pow2Capacity.
+ * @tparam Layout Slot storage layout, InterleavedLayout or SplitLayout.
+ * @tparam SearchPolicy Insertion offset search beyond rankSearchLimit, BinarySearch or BranchlessSearch.
+ * @tparam TiePolicy Placement of equal keys, LifoTies or StableTies.
+ */
+template<typename V, typename Comparator,
+         typename K = decltype(std::declval<Comparator>().comparisonValue(std::declval<V>())),
+         typename CapacityPolicy = ExactCapacity, typename Layout = InterleavedLayout,
+         typename SearchPolicy = BinarySearch, typename TiePolicy = LifoTies>
+class BoundedPriorityDeque
+        : public BoundedPriorityDequeBase<K, V, Comparator, CapacityPolicy, Layout, SearchPolicy, TiePolicy> {
+public:
+    using Base = BoundedPriorityDequeBase<K, V, Comparator, CapacityPolicy, Layout, SearchPolicy, TiePolicy>;
+
+protected:
+    constexpr K extractKey(const V& value) const {
+        return this->comparator.comparisonValue(value);
+    }
+
+public:
+    constexpr explicit BoundedPriorityDeque(unsigned int capacity = 0, Comparator comp = Comparator()) :
+            Base(capacity, comp) {}
+
+    constexpr BoundedPriorityDeque(unsigned int capacity, Comparator comp, const typename Base::allocator_type& allocator) :
+            Base(capacity, comp, allocator) {}
+
+    constexpr void emplace(const V& value) {
+        K key = extractKey(value);
+        Base::emplace(key, value);
+    }
+
+    constexpr void emplace(V&& value) {
+        K key = extractKey(value);
+        Base::emplace(key, std::move(value));
+    }
+
+    constexpr void push(const V& value) { emplace(value); }
+
+    constexpr void push(V&& value) { emplace(std::move(value)); }
+};
+
+/**
+ * @class StaticBoundedPriorityDeque
+ * @brief Bounded priority deque with a compile time capacity, stored inline without any heap allocation.
+ *
+ * The slots live in std::arrays inside the object and the capacity policy wraps indices by the constant N,
+ * which the compiler reduces to a mask for powers of two and to a multiply otherwise. Shares the complete
+ * push, pop and merge surface of BoundedPriorityDequeBase, switching between the two is a template alias away.
+ * resize() may shrink the logical capacity, growing it beyond N throws std::runtime_error in every build and
+ * leaves the deque unchanged.
+ *
+ * Everything short of serialization is constexpr, so small best-k tables can be computed at compile time with
+ * the same code that runs at run time. Constant evaluation falls back from rankSearch() to binarySearch() and
+ * from memmove to element-wise relocation, and skips the ENABLE_DEQUE_STATS counters.
+ *
+ * @tparam K Type of the key.
+ * @tparam V Type of the value.
+ * @tparam N The capacity.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @tparam Layout InlineInterleavedLayout<N> or InlineSplitLayout<N>.
+ * @tparam SearchPolicy Insertion offset search beyond rankSearchLimit, BinarySearch or BranchlessSearch.
+ * @tparam TiePolicy Placement of equal keys, LifoTies or StableTies.
+ */
+template<typename K, typename V, size_t N, typename Compare = std::less<K>, typename Layout = InlineInterleavedLayout<N>,
+         typename SearchPolicy = BinarySearch, typename TiePolicy = LifoTies>
+class StaticBoundedPriorityDeque
+        : public BoundedPriorityDequeBase<K, V, Compare, ExactCapacity, Layout, SearchPolicy, TiePolicy> {
+public:
+    using Base = BoundedPriorityDequeBase<K, V, Compare, ExactCapacity, Layout, SearchPolicy, TiePolicy>;
+
+    constexpr explicit StaticBoundedPriorityDeque(size_t capacity = N, Compare comp = Compare()) : Base(capacity, comp) {}
+
+    template<std::input_iterator InputIt>
+    constexpr StaticBoundedPriorityDeque(InputIt first, InputIt last, Compare comp = Compare()) : Base(N, first, last, comp) {}
+};
+
+/**
+ * @class BoundedPriorityHeap
+ * @brief Bounded priority queue for large k, a min-max heap with O(log k) insertion at any priority.
+ *
+ * The deques keep their elements sorted, so every accepted element landing mid-buffer shifts O(k) slots,
+ * which dominates once k reaches the thousands. The min-max heap keeps both the highest and the lowest
+ * priority element at hand instead: even levels hold elements of higher priority than all their
+ * descendants, odd levels of lower priority. push(), pop() and popBottom() are O(log k), top() and bottom()
+ * O(1). In exchange there is no positional access, sorted() produces the elements in priority order on
+ * demand. The order of equal keys is unspecified.
+ *
+ * Offers the same push, pop, merge and capacity surface as BoundedPriorityDequeBase, see
+ * BoundedPriorityDequeFor for choosing between the two by the expected capacity.
+ *
+ * @tparam K Type of the key.
+ * @tparam V Type of the value.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @tparam Allocator Allocator for BoundingPair<K, V>.
+ */
+template<typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<BoundingPair<K, V>>>
+class BoundedPriorityHeap {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = BoundingPair<K, V>;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using const_reference = const value_type&;
+
+private:
+    std::vector<value_type, Allocator> _heap;
+    size_t _k;
+    [[no_unique_address]] Compare comparator;
+
+    [[nodiscard]] bool higher(size_t a, size_t b) const { return comparator(_heap[a].key, _heap[b].key); }
+    [[nodiscard]] static bool onMinLevel(size_t index) { return (std::bit_width(index + 1) & 1) == 1; }
+    [[nodiscard]] static size_t parent(size_t index) { return (index - 1) / 2; }
+
+    /**
+     * @return The index of the lowest-priority element, one of the children of the root.
+     */
+    [[nodiscard]] size_t bottomIndex() const {
+        if (_heap.size() < 3) return _heap.size() - 1;
+        return higher(1, 2) ? 2 : 1;
+    }
+
+    /**
+     * @brief Moves the element at index up along its grandparents, towards the top on a min level.
+     */
+    template<bool MinLevel>
+    void bubbleUpLevel(size_t index) {
+        while (index > 2) {
+            auto grandparent = parent(parent(index));
+            if (MinLevel ? !higher(index, grandparent) : !higher(grandparent, index)) break;
+            std::swap(_heap[index], _heap[grandparent]);
+            index = grandparent;
+        }
+    }
+
+    /**
+     * @brief Restores the heap after appending an element at index.
+     */
+    void bubbleUp(size_t index) {
+        if (index == 0) return;
+        auto up = parent(index);
+        if (onMinLevel(index)) {
+            if (higher(up, index)) {
+                std::swap(_heap[index], _heap[up]);
+                bubbleUpLevel<false>(up);
+            } else bubbleUpLevel<true>(index);
+        } else {
+            if (higher(index, up)) {
+                std::swap(_heap[index], _heap[up]);
+                bubbleUpLevel<true>(up);
+            } else bubbleUpLevel<false>(index);
+        }
+    }
+
+    /**
+     * @brief Moves the element at index down, swapping with the highest-priority descendant on a min level
+     * and the lowest-priority one on a max level.
+     */
+    template<bool MinLevel>
+    void trickleDownLevel(size_t index) {
+        auto ranksFirst = [this](size_t a, size_t b) { return MinLevel ? higher(a, b) : higher(b, a); };
+        auto size = _heap.size();
+        while (2 * index + 1 < size) {
+            auto first = 2 * index + 1, best = first;
+            if (first + 1 < size && ranksFirst(first + 1, best)) best = first + 1;
+            for (auto grandchild = 2 * first + 1; grandchild < std::min(size, 2 * first + 5); ++grandchild) {
+                if (ranksFirst(grandchild, best)) best = grandchild;
+            }
+            if (!ranksFirst(best, index)) return;
+            std::swap(_heap[best], _heap[index]);
+            if (best <= first + 1) return;
+            if (ranksFirst(parent(best), best)) std::swap(_heap[best], _heap[parent(best)]);
+            index = best;
+        }
+    }
+
+    /**
+     * @brief Restores the heap after replacing the element at index with one from the end.
+     */
+    void trickleDown(size_t index) {
+        if (onMinLevel(index)) trickleDownLevel<true>(index);
+        else trickleDownLevel<false>(index);
+    }
+
+    /**
+     * @brief Replaces the element at index with the last element and restores the heap.
+     */
+    void erase(size_t index) {
+        if (index + 1 != _heap.size()) _heap[index] = std::move(_heap.back());
+        _heap.pop_back();
+        if (index < _heap.size()) trickleDown(index);
+    }
+
+    /**
+     * @brief Runs the capacity check ahead of an insertion, see BoundedPriorityDequeBase::admit().
+     */
+    [[nodiscard]] bool admit(const K& key) {
+        if (_heap.size() == _k) {
+            if (_k > 0 && comparator(key, _heap[bottomIndex()].key)) erase(bottomIndex());
+            else return false;
+        }
+        return true;
+    }
+
+public:
+    /**
+     * @brief Primary constructor, reserves the heap for the capacity up front.
+     *
+     * @param capacity The bounding capacity.
+     * @param comp The comparator instance, only relevant for stateful comparators.
+     * @param allocator The allocator of the heap array.
+     */
+    explicit BoundedPriorityHeap(size_t capacity = 0, Compare comp = Compare(), const Allocator& allocator = Allocator()) :
+            _heap(allocator), _k(capacity), comparator(comp) {
+        _heap.reserve(capacity);
+    }
+
+    /**
+     * @brief Range constructor, keeps the top-k of the given elements.
+     */
+    template<std::input_iterator InputIt>
+    BoundedPriorityHeap(size_t capacity, InputIt first, InputIt last, Compare comp = Compare()) :
+            BoundedPriorityHeap(capacity, comp) {
+        pushRange(first, last);
+    }
+
+    /**
+     * @return The highest-priority element.
+     */
+    const_reference top() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access top element of empty BoundedPriorityHeap");
+#endif
+        return _heap[0];
+    }
+
+    /**
+     * @return The lowest-priority element, the next one to be pruned.
+     */
+    const_reference bottom() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityHeap");
+#endif
+        return _heap[bottomIndex()];
+    }
+
+    [[nodiscard]] K topK() const { return top().key; }
+    [[nodiscard]] K bottomK() const { return bottom().key; }
+
+    /**
+     * @brief The key a candidate must outrank to be accepted, see BoundedPriorityDequeBase::threshold().
+     */
+    [[nodiscard]] K threshold() const requires is_builtin_ordering_v<Compare, K> {
+        constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+        using limits = std::numeric_limits<K>;
+        constexpr K highest = limits::has_infinity ? limits::infinity() : limits::max();
+        constexpr K lowest = limits::has_infinity ? -limits::infinity() : limits::lowest();
+        if (full()) return _k == 0 ? (ascending ? lowest : highest) : bottomK();
+        return ascending ? highest : lowest;
+    }
+
+    /**
+     * @brief constructs the value from the given arguments if the key is accepted, then inserts it.
+     *
+     * @param key The bounding key value
+     * @param args The arguments forwarded to the value constructor.
+     */
+    template<typename... Args>
+    void emplace(const K& key, Args&&... args) {
+        if (!admit(key)) return;
+        _heap.push_back({ key, V(std::forward<Args>(args)...) });
+        bubbleUp(_heap.size() - 1);
+    }
+
+    void push(const value_type& element) {
+        if (!admit(element.key)) return;
+        _heap.push_back(element);
+        bubbleUp(_heap.size() - 1);
+    }
+
+    void push(value_type&& element) {
+        if (!admit(element.key)) return;
+        _heap.push_back(std::move(element));
+        bubbleUp(_heap.size() - 1);
+    }
+
+    /**
+     * @brief Inserts a range of elements, anything exposing key and value members.
+     */
+    template<std::input_iterator InputIt>
+    void pushRange(InputIt first, InputIt last) {
+        for (; first != last; ++first) emplace(first->key, first->value);
+    }
+
+    /**
+     * @brief remove the highest-priority element.
+     *
+     * @return The removed highest-priority element.
+     */
+    value_type pop() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityHeap");
+#endif
+        auto element = std::move(_heap[0]);
+        erase(0);
+        return element;
+    }
+
+    /**
+     * @brief remove the lowest-priority element.
+     *
+     * @return The removed lowest-priority element.
+     */
+    value_type popBottom() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityHeap");
+#endif
+        auto index = bottomIndex();
+        auto element = std::move(_heap[index]);
+        erase(index);
+        return element;
+    }
+
+    void discardTop() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityHeap");
+#endif
+        erase(0);
+    }
+
+    void discardBottom() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty BoundedPriorityHeap");
+#endif
+        erase(bottomIndex());
+    }
+
+    /**
+     * @brief Merges another heap into this one, elements that cannot make the cut are skipped.
+     *
+     * @param rhs The heap being merged, left untouched.
+     */
+    void operator+=(const BoundedPriorityHeap& rhs) {
+        if (this == &rhs) {
+            auto copy = rhs;
+            *this += std::move(copy);
+        } else {
+            for (const auto& element : rhs._heap) push(element);
+        }
+    }
+
+    /**
+     * @brief Merges another heap into this one, moving the values. The incoming heap is left empty.
+     *
+     * @param rhs The heap being merged.
+     */
+    void operator+=(BoundedPriorityHeap&& rhs) {
+        if (this == &rhs) return;
+        for (auto& element : rhs._heap) push(std::move(element));
+        rhs.clear();
+    }
+
+    /**
+     * @brief Copies the elements out in priority order, O(k log k).
+     *
+     * @return The elements, highest-priority first.
+     */
+    [[nodiscard]] std::vector<value_type, Allocator> sorted() const {
+        auto result = _heap;
+        std::sort(result.begin(), result.end(), [this](const value_type& a, const value_type& b) {
+            return comparator(a.key, b.key);
+        });
+        return result;
+    }
+
+    /**
+     * @return The elements in heap order, without copying them.
+     */
+    [[nodiscard]] std::span<const value_type> elements() const { return _heap; }
+
+    void clear() { _heap.clear(); }
+
+    [[nodiscard]] allocator_type get_allocator() const { return _heap.get_allocator(); }
+    [[nodiscard]] size_t size() const { return _heap.size(); }
+    [[nodiscard]] size_t capacity() const { return _k; }
+    [[nodiscard]] bool empty() const { return _heap.empty(); }
+    [[nodiscard]] bool full() const { return _heap.size() == _k; }
+
+    /**
+     * @brief Preallocates the heap for capacities up to maxK.
+     */
+    void reserve(size_t maxK) { _heap.reserve(maxK); }
+
+    /**
+     * @brief Sets the capacity, dropping the lowest-priority elements when shrinking.
+     *
+     * @param k The new capacity.
+     */
+    void resize(size_t k) {
+        if (k == 0) return;
+        while (_heap.size() > k) erase(bottomIndex());
+        _heap.reserve(k);
+        _k = k;
+    }
+};
+
+/**
+ * @brief Expected capacities from this size up are served by BoundedPriorityHeap, see BoundedPriorityDequeFor.
+ */
+inline constexpr size_t heapBackendThreshold = 1024;
+
+/**
+ * @brief Picks the backend for an expected capacity: the sorted BoundedPriorityDequeKeyed below
+ * heapBackendThreshold, with O(1) positional access, and BoundedPriorityHeap above it.
+ *
+ * @tparam K Type of the key.
+ * @tparam V Type of the value.
+ * @tparam ExpectedK The capacity the deque is expected to run with.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ */
+template<typename K, typename V, size_t ExpectedK, typename Compare = std::less<K>>
+using BoundedPriorityDequeFor = std::conditional_t<(ExpectedK >= heapBackendThreshold), BoundedPriorityHeap<K, V, Compare>,
+                                                   BoundedPriorityDequeKeyed<K, V, Compare>>;
+
+/**
+ * @class LazyBoundedPriorityDeque
+ * @brief Bounded priority queue for write-heavy workloads, collects candidates unsorted and sorts on first read.
+ *
+ * push() appends accepted elements to a buffer of 2k slots. Once the buffer fills up, nth_element cuts it
+ * back to the k highest-priority elements and the lowest of those becomes the rejection threshold, so
+ * insertion is amortized O(1) instead of a search and a shift. The first top(), bottom(), operator[] or
+ * iteration after a push sorts the remaining elements once, reads after that are O(1) until the next push.
+ *
+ * Holds the same elements as BoundedPriorityDequeBase fed the same stream, except that the order of equal
+ * keys, and which of them survive a cut, is unspecified. The reads reorganize the buffer, so unlike the
+ * other deques concurrent const access needs external synchronization.
+ *
+ * @tparam K Type of the key.
+ * @tparam V Type of the value.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @tparam Allocator Allocator for BoundingPair<K, V>.
+ */
+template<typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<BoundingPair<K, V>>>
+class LazyBoundedPriorityDeque {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = BoundingPair<K, V>;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using const_reference = const value_type&;
+    using const_iterator = std::reverse_iterator<typename std::vector<value_type, Allocator>::const_iterator>;
+    using iterator = const_iterator;
+
+private:
+    // Sorted lowest-priority first once finalized, so that pop() takes from the back.
+    mutable std::vector<value_type, Allocator> _buffer;
+    size_t _k;
+    mutable bool _sorted = true;
+    bool _hasCut = false;
+    K _cut{};
+    [[no_unique_address]] Compare comparator;
+
+    [[nodiscard]] bool ranksLower(const value_type& a, const value_type& b) const {
+        return comparator(b.key, a.key);
+    }
+
+    /**
+     * @brief Cuts the buffer back to the k highest-priority elements, the lowest of them ends up in front.
+     */
+    void cut() const {
+        auto kept = _buffer.end() - static_cast<std::ptrdiff_t>(_k);
+        std::nth_element(_buffer.begin(), kept, _buffer.end(),
+                         [this](const value_type& a, const value_type& b) { return ranksLower(a, b); });
+        _buffer.erase(_buffer.begin(), kept);
+        _sorted = false;
+    }
+
+    /**
+     * @brief Sorts the buffer ahead of a read, cutting it back to k first.
+     */
+    void finalizeBuffer() const {
+        if (_sorted) return;
+        if (_buffer.size() > _k) cut();
+        std::sort(_buffer.begin(), _buffer.end(),
+                  [this](const value_type& a, const value_type& b) { return ranksLower(a, b); });
+        _sorted = true;
+    }
+
+    /**
+     * @brief Runs the threshold check ahead of an insertion, cutting the buffer when it is full.
+     */
+    [[nodiscard]] bool admit(const K& key) {
+        if (_hasCut && !comparator(key, _cut)) return false;
+        if (_buffer.size() == 2 * _k) {
+            if (_k == 0) return false;
+            cut();
+            _cut = _buffer.front().key;
+            _hasCut = true;
+            if (!comparator(key, _cut)) return false;
+        }
+        _sorted = false;
+        return true;
+    }
+
+    /**
+     * @brief Drops the threshold once an element is removed, the deque accepts anything again until full.
+     */
+    void released() { _hasCut = false; }
+
+public:
+    /**
+     * @brief Primary constructor, reserves the 2k buffer up front.
+     *
+     * @param capacity The bounding capacity.
+     * @param comp The comparator instance, only relevant for stateful comparators.
+     * @param allocator The allocator of the buffer.
+     */
+    explicit LazyBoundedPriorityDeque(size_t capacity = 0, Compare comp = Compare(),
+                                      const Allocator& allocator = Allocator()) :
+            _buffer(allocator), _k(capacity), comparator(comp) {
+        _buffer.reserve(2 * capacity);
+    }
+
+    /**
+     * @brief Range constructor, keeps the top-k of the given elements.
+     */
+    template<std::input_iterator InputIt>
+    LazyBoundedPriorityDeque(size_t capacity, InputIt first, InputIt last, Compare comp = Compare()) :
+            LazyBoundedPriorityDeque(capacity, comp) {
+        pushRange(first, last);
+    }
+
+    /**
+     * @brief Sorts the collected elements now instead of on the first read.
+     */
+    void finalize() const { finalizeBuffer(); }
+
+    /**
+     * @return The highest-priority element.
+     */
+    const_reference top() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access top element of empty LazyBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        return _buffer.back();
+    }
+
+    /**
+     * @return The lowest-priority element.
+     */
+    const_reference bottom() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty LazyBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        return _buffer.front();
+    }
+
+    [[nodiscard]] K topK() const { return top().key; }
+    [[nodiscard]] K bottomK() const { return bottom().key; }
+
+    /**
+     * @param offsetTop The offset from the highest-priority element.
+     * @return The element offsetTop positions below the top.
+     */
+    const_reference operator[](size_t offsetTop) const {
+        finalizeBuffer();
+        return _buffer[_buffer.size() - 1 - offsetTop];
+    }
+
+    /**
+     * @return An iterator to the highest-priority element.
+     */
+    [[nodiscard]] const_iterator begin() const {
+        finalizeBuffer();
+        return const_iterator(_buffer.cend());
+    }
+
+    /**
+     * @return An iterator past the lowest-priority element.
+     */
+    [[nodiscard]] const_iterator end() const {
+        finalizeBuffer();
+        return const_iterator(_buffer.cbegin());
+    }
+
+    /**
+     * @brief The key a candidate must outrank to be accepted, see BoundedPriorityDequeBase::threshold().
+     *
+     * Only tightens when the buffer is cut, so candidates between the true k-th key and this threshold are
+     * still collected and dropped at the next cut.
+     */
+    [[nodiscard]] K threshold() const requires is_builtin_ordering_v<Compare, K> {
+        constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+        using limits = std::numeric_limits<K>;
+        constexpr K highest = limits::has_infinity ? limits::infinity() : limits::max();
+        constexpr K lowest = limits::has_infinity ? -limits::infinity() : limits::lowest();
+        if (_k == 0) return ascending ? lowest : highest;
+        if (_hasCut) return _cut;
+        return ascending ? highest : lowest;
+    }
+
+    /**
+     * @brief constructs the value from the given arguments if the key is accepted, then appends it.
+     *
+     * @param key The bounding key value
+     * @param args The arguments forwarded to the value constructor.
+     */
+    template<typename... Args>
+    void emplace(const K& key, Args&&... args) {
+        if (!admit(key)) return;
+        _buffer.push_back({ key, V(std::forward<Args>(args)...) });
+    }
+
+    void push(const value_type& element) {
+        if (!admit(element.key)) return;
+        _buffer.push_back(element);
+    }
+
+    void push(value_type&& element) {
+        if (!admit(element.key)) return;
+        _buffer.push_back(std::move(element));
+    }
+
+    /**
+     * @brief Inserts a range of elements, anything exposing key and value members.
+     */
+    template<std::input_iterator InputIt>
+    void pushRange(InputIt first, InputIt last) {
+        for (; first != last; ++first) emplace(first->key, first->value);
+    }
+
+    /**
+     * @brief remove the highest-priority element.
+     *
+     * @return The removed highest-priority element.
+     */
+    value_type pop() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty LazyBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        auto element = std::move(_buffer.back());
+        _buffer.pop_back();
+        released();
+        return element;
+    }
+
+    /**
+     * @brief remove the lowest-priority element, O(k) as the buffer is shifted down.
+     *
+     * @return The removed lowest-priority element.
+     */
+    value_type popBottom() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty LazyBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        auto element = std::move(_buffer.front());
+        _buffer.erase(_buffer.begin());
+        released();
+        return element;
+    }
+
+    void discardTop() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty LazyBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        _buffer.pop_back();
+        released();
+    }
+
+    void discardBottom() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty LazyBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        _buffer.erase(_buffer.begin());
+        released();
+    }
+
+    /**
+     * @brief Merges another deque into this one, without sorting either of them.
+     *
+     * @param rhs The deque being merged, left untouched.
+     */
+    void operator+=(const LazyBoundedPriorityDeque& rhs) {
+        if (this == &rhs) {
+            auto copy = rhs;
+            *this += std::move(copy);
+        } else {
+            for (const auto& element : rhs._buffer) push(element);
+        }
+    }
+
+    /**
+     * @brief Merges another deque into this one, moving the values. The incoming deque is left empty.
+     *
+     * @param rhs The deque being merged.
+     */
+    void operator+=(LazyBoundedPriorityDeque&& rhs) {
+        if (this == &rhs) return;
+        for (auto& element : rhs._buffer) push(std::move(element));
+        rhs.clear();
+    }
+
+    void clear() {
+        _buffer.clear();
+        _sorted = true;
+        released();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const { return _buffer.get_allocator(); }
+    [[nodiscard]] size_t size() const { return std::min(_buffer.size(), _k); }
+    [[nodiscard]] size_t capacity() const { return _k; }
+    [[nodiscard]] bool empty() const { return _buffer.empty(); }
+    [[nodiscard]] bool full() const { return size() == _k; }
+
+    /**
+     * @brief Preallocates the buffer for capacities up to maxK.
+     */
+    void reserve(size_t maxK) { _buffer.reserve(2 * maxK); }
+
+    /**
+     * @brief Sets the capacity, dropping the lowest-priority elements when shrinking.
+     *
+     * @param k The new capacity.
+     */
+    void resize(size_t k) {
+        if (k == 0) return;
+        if (k > _k) released();
+        _k = k;
+        if (_buffer.size() > k) cut();
+        _buffer.reserve(2 * k);
+    }
+};
+
+/**
+ * @class ApproximateBoundedPriorityDeque
+ * @brief Bounded priority queue for streaming ingest, exact up to one bucket of a quantized key range.
+ *
+ * The key range [lo, hi) is split into equal buckets, counted for the elements held. A full deque rejects
+ * everything from the bucket of its lowest-priority element on, with a subtraction and a compare, and an
+ * accepted key only updates two bucket counts and is appended to an unsorted buffer. A key landing in a
+ * better bucket evicts one element of that boundary bucket by count, the buffer itself is compacted in one
+ * linear pass once it reaches 2k elements. Nothing is searched, shifted or selected on the push path.
+ *
+ * Error bound: every pushed key in a bucket ahead of the final boundary bucket is held, exactly as in
+ * BoundedPriorityDequeBase, and the remaining elements are some of the boundary bucket, not necessarily
+ * its best. Read in priority order, the i-th key therefore differs from the exact
+ * i-th key by less than resolution(), and not at all ahead of the boundary bucket. Keys outside [lo, hi)
+ * are clamped into the first or last bucket, where the bound does not hold. NaN keys are rejected.
+ *
+ * Reads sort the held elements on first use, as in LazyBoundedPriorityDeque, and so need external
+ * synchronization when shared.
+ *
+ * @tparam K Type of the key, arithmetic.
+ * @tparam V Type of the value.
+ * @tparam Compare std::less or std::greater, the direction of the builtin key order.
+ * @tparam Allocator Allocator for BoundingPair<K, V>.
+ */
+template<typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<BoundingPair<K, V>>>
+requires is_builtin_ordering_v<Compare, K>
+class ApproximateBoundedPriorityDeque {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = BoundingPair<K, V>;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using const_reference = const value_type&;
+    using const_iterator = std::reverse_iterator<typename std::vector<value_type, Allocator>::const_iterator>;
+    using iterator = const_iterator;
+
+    static constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+
+private:
+    // Sorted lowest-priority first once finalized, dead elements of evicted buckets linger until compaction.
+    using Counts = std::vector<size_t, typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>>;
+
+    mutable std::vector<value_type, Allocator> _buffer;
+    Counts _counts;
+    mutable Counts _cursors;
+    size_t _k, _held = 0, _boundary = 0;
+    double _lo, _hi, _scale, _width, _last, _cut = 0, _reject = 0;
+    mutable bool _sorted = true;
+    [[no_unique_address]] Compare comparator;
+
+    /**
+     * @brief The distance of a key from the high-priority end of the range in buckets, clamped to the range.
+     *
+     * The bucket of a key is the integer part, so comparing a position against a bucket index as a double
+     * classifies it exactly like the bucket itself, without a conversion. A NaN key maps to the last bucket.
+     */
+    [[nodiscard]] double position(const K& key) const {
+        auto at = (ascending ? static_cast<double>(key) - _lo : _hi - static_cast<double>(key)) * _scale;
+        return at < _last ? std::max(at, 0.0) : _last;
+    }
+
+    [[nodiscard]] size_t bucketOf(const K& key) const { return static_cast<size_t>(position(key)); }
+
+    /**
+     * @brief Sets the boundary bucket and the key past which a full deque rejects without computing a position.
+     *
+     * The rejection key sits a millionth of a bucket past the edge of the boundary bucket, keys between the
+     * two are settled by the exact position test.
+     */
+    void setBoundary(size_t bucket) {
+        constexpr double never = std::numeric_limits<double>::infinity();
+        _boundary = bucket;
+        _cut = static_cast<double>(bucket);
+        auto edge = (_cut + 1e-6) * _width;
+        if (bucket == 0) _reject = ascending ? -never : never;
+        else _reject = ascending ? _lo + edge : _hi - edge;
+    }
+
+    /**
+     * @brief Moves the boundary back to the last bucket still holding elements.
+     */
+    void settleBoundary() {
+        auto bucket = _boundary;
+        while (bucket > 0 && _counts[bucket] == 0) --bucket;
+        setBoundary(bucket);
+    }
+
+    /**
+     * @brief Counts an element in, evicting one element of the boundary bucket from a full deque.
+     *
+     * @return False if the key is rejected.
+     */
+    [[nodiscard]] bool admit(const K& key) {
+        if constexpr (std::is_floating_point_v<K>) {
+            if (std::isnan(key)) return false;
+        }
+        if (_held == _k) {
+            if (ascending ? static_cast<double>(key) >= _reject : static_cast<double>(key) <= _reject) return false;
+            auto at = position(key);
+            if (at >= _cut) return false;
+            ++_counts[static_cast<size_t>(at)];
+            if (--_counts[_boundary] == 0) settleBoundary();
+        } else {
+            auto bucket = bucketOf(key);
+            ++_counts[bucket];
+            ++_held;
+            if (bucket > _boundary) setBoundary(bucket);
+        }
+        _sorted = false;
+        return true;
+    }
+
+    /**
+     * @brief Drops the evicted elements from the buffer, keeping as many of the boundary bucket as counted.
+     */
+    void compact() const {
+        auto quota = _counts[_boundary];
+        auto live = std::remove_if(_buffer.begin(), _buffer.end(), [this, &quota](const value_type& element) {
+            auto at = position(element.key);
+            if (at < _cut) return false;
+            if (at < _cut + 1 && quota > 0) {
+                --quota;
+                return false;
+            }
+            return true;
+        });
+        _buffer.erase(live, _buffer.end());
+    }
+
+    /**
+     * @brief Compacts and sorts the buffer ahead of a read.
+     *
+     * Past a few elements per bucket, the elements are first permuted in place into the ranges their bucket
+     * counts dictate, then each bucket is sorted on its own, O(n + B) instead of O(n log n).
+     */
+    void finalizeBuffer() const {
+        if (_sorted) return;
+        if (_buffer.size() > _held) compact();
+
+        auto lower = [this](const value_type& a, const value_type& b) { return comparator(b.key, a.key); };
+        if (_held * 4 < _boundary) std::sort(_buffer.begin(), _buffer.end(), lower);
+        else {
+            _cursors.resize(_boundary + 1);
+            for (size_t bucket = 0, end = _held; bucket <= _boundary; ++bucket) {
+                end -= _counts[bucket];
+                _cursors[bucket] = end;
+            }
+            for (size_t bucket = 0, end = _held; bucket <= _boundary; end -= _counts[bucket], ++bucket) {
+                auto begin = end - _counts[bucket];
+                for (auto& cursor = _cursors[bucket]; cursor < end;) {
+                    auto target = bucketOf(_buffer[cursor].key);
+                    if (target == bucket) ++cursor;
+                    else std::swap(_buffer[cursor], _buffer[_cursors[target]++]);
+                }
+                std::sort(_buffer.begin() + static_cast<std::ptrdiff_t>(begin),
+                          _buffer.begin() + static_cast<std::ptrdiff_t>(end), lower);
+            }
+        }
+        _sorted = true;
+    }
+
+    template<typename Element>
+    void append(Element&& element) {
+        _buffer.push_back(std::forward<Element>(element));
+        if (_buffer.size() == 2 * _k) compact();
+    }
+
+    /**
+     * @brief Uncounts an element that left the deque.
+     */
+    void released(const K& key) {
+        --_counts[bucketOf(key)];
+        if (--_held == 0) setBoundary(0);
+        else settleBoundary();
+    }
+
+public:
+    /**
+     * @brief Primary constructor.
+     *
+     * @param capacity The bounding capacity.
+     * @param lo The lowest key of the expected range.
+     * @param hi The end of the expected key range, above lo, std::runtime_error is thrown otherwise.
+     * @param buckets The number of buckets over [lo, hi), resolution() is their width.
+     * @param comp The comparator instance.
+     * @param allocator The allocator of the buffer.
+     */
+    ApproximateBoundedPriorityDeque(size_t capacity, K lo, K hi, size_t buckets = 4096, Compare comp = Compare(),
+                                    const Allocator& allocator = Allocator()) :
+            _buffer(allocator), _counts(std::max<size_t>(buckets, 1), 0, allocator), _cursors(allocator), _k(capacity),
+            _lo(static_cast<double>(lo)), _hi(static_cast<double>(hi)),
+            _scale(static_cast<double>(_counts.size()) / (_hi - _lo)), _width(1 / _scale),
+            _last(static_cast<double>(_counts.size() - 1)),
+            comparator(comp) {
+        if (!(_lo < _hi) || !std::isfinite(_scale) || !std::isfinite(_width)) {
+            throw std::runtime_error("Empty or unbounded key range for ApproximateBoundedPriorityDeque");
+        }
+        _buffer.reserve(2 * capacity);
+        setBoundary(0);
+    }
+
+    /**
+     * @return The width of a bucket, the bound on the key error at any rank.
+     */
+    [[nodiscard]] double resolution() const { return _width; }
+
+    /**
+     * @brief Compacts and sorts the held elements now instead of on the first read.
+     */
+    void finalize() const { finalizeBuffer(); }
+
+    const_reference top() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access top element of empty ApproximateBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        return _buffer.back();
+    }
+
+    const_reference bottom() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty ApproximateBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        return _buffer.front();
+    }
+
+    [[nodiscard]] K topK() const { return top().key; }
+    [[nodiscard]] K bottomK() const { return bottom().key; }
+
+    /**
+     * @param offsetTop The offset from the highest-priority element.
+     * @return The element offsetTop positions below the top.
+     */
+    const_reference operator[](size_t offsetTop) const {
+        finalizeBuffer();
+        return _buffer[_buffer.size() - 1 - offsetTop];
+    }
+
+    [[nodiscard]] const_iterator begin() const {
+        finalizeBuffer();
+        return const_iterator(_buffer.cend());
+    }
+
+    [[nodiscard]] const_iterator end() const {
+        finalizeBuffer();
+        return const_iterator(_buffer.cbegin());
+    }
+
+    /**
+     * @brief The key a candidate must outrank to be considered, the start of the boundary bucket once full.
+     */
+    [[nodiscard]] K threshold() const {
+        using limits = std::numeric_limits<K>;
+        constexpr K highest = limits::has_infinity ? limits::infinity() : limits::max();
+        constexpr K lowest = limits::has_infinity ? -limits::infinity() : limits::lowest();
+        if (_k == 0) return ascending ? lowest : highest;
+        if (_held == _k) return static_cast<K>(ascending ? _lo + _cut * _width : _hi - _cut * _width);
+        return ascending ? highest : lowest;
+    }
+
+    /**
+     * @brief constructs the value from the given arguments if the key is accepted, then appends it.
+     *
+     * @param key The bounding key value
+     * @param args The arguments forwarded to the value constructor.
+     */
+    template<typename... Args>
+    void emplace(const K& key, Args&&... args) {
+        if (admit(key)) append(value_type { key, V(std::forward<Args>(args)...) });
+    }
+
+    void push(const value_type& element) {
+        if (admit(element.key)) append(element);
+    }
+
+    void push(value_type&& element) {
+        if (admit(element.key)) append(std::move(element));
+    }
+
+    /**
+     * @brief Inserts a range of elements, anything exposing key and value members.
+     */
+    template<std::input_iterator InputIt>
+    void pushRange(InputIt first, InputIt last) {
+        for (; first != last; ++first) emplace(first->key, first->value);
+    }
+
+    /**
+     * @brief remove the highest-priority element.
+     *
+     * @return The removed highest-priority element.
+     */
+    value_type pop() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty ApproximateBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        auto element = std::move(_buffer.back());
+        _buffer.pop_back();
+        released(element.key);
+        return element;
+    }
+
+    /**
+     * @brief remove the lowest-priority element, O(k) as the buffer is shifted down.
+     *
+     * @return The removed lowest-priority element.
+     */
+    value_type popBottom() {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to pop from empty ApproximateBoundedPriorityDeque");
+#endif
+        finalizeBuffer();
+        auto element = std::move(_buffer.front());
+        _buffer.erase(_buffer.begin());
+        released(element.key);
+        return element;
+    }
+
+    /**
+     * @brief Merges another deque into this one, offering it the held elements of rhs.
+     *
+     * @param rhs The deque being merged, compacted but otherwise left untouched.
+     */
+    void operator+=(const ApproximateBoundedPriorityDeque& rhs) {
+        if (this == &rhs) {
+            auto copy = rhs;
+            *this += std::move(copy);
+            return;
+        }
+        if (rhs._buffer.size() > rhs._held) rhs.compact();
+        for (const auto& element : rhs._buffer) push(element);
+    }
+
+    /**
+     * @brief Merges another deque into this one, moving the values. The incoming deque is left empty.
+     *
+     * @param rhs The deque being merged.
+     */
+    void operator+=(ApproximateBoundedPriorityDeque&& rhs) {
+        if (this == &rhs) return;
+        if (rhs._buffer.size() > rhs._held) rhs.compact();
+        for (auto& element : rhs._buffer) push(std::move(element));
+        rhs.clear();
+    }
+
+    void clear() {
+        _buffer.clear();
+        std::ranges::fill(_counts, 0);
+        _held = 0;
+        setBoundary(0);
+        _sorted = true;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const { return _buffer.get_allocator(); }
+    [[nodiscard]] size_t size() const { return _held; }
+    [[nodiscard]] size_t capacity() const { return _k; }
+    [[nodiscard]] bool empty() const { return _held == 0; }
+    [[nodiscard]] bool full() const { return _held == _k; }
+};
+
+/**
+ * @class BoundedPriorityDequeBatch
+ * @brief A batch of independent fixed-capacity deques sharing one aligned slab, one per query.
+ *
+ * Batched k-NN keeps one top-k per query. Rather than one deque object and heap buffer each, every query
+ * owns a circular run of k key and value slots in a single allocation, and the per-query _head, _tail and
+ * _size indices as well as the bottom keys live in arrays of their own. The admission test of pushAll()
+ * therefore reads two contiguous arrays indexed by query, and only accepted candidates touch a query's
+ * slots. Insertion is the single tailward scan of openSlotLinear(), suited to the small k of such kernels,
+ * and equal keys are placed as under LifoTies.
+ *
+ * Keys and values are copied bytewise and never destroyed, so both have to be trivially copyable.
+ *
+ * @tparam K Type of the key.
+ * @tparam V Type of the value.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ */
+template<typename K, typename V, typename Compare = std::less<K>>
+requires std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V> &&
+         std::is_default_constructible_v<K> && std::is_default_constructible_v<V>
+class BoundedPriorityDequeBatch {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = BoundingPair<K, V>;
+    using key_compare = Compare;
+
+    /**
+     * @brief Alignment of every array in the slab, a cache line.
+     */
+    static constexpr size_t slabAlignment = 64;
+
+private:
+    struct SlabDeleter {
+        void operator()(std::byte* slab) const { ::operator delete(slab, std::align_val_t{ slabAlignment }); }
+    };
+
+    size_t _queries, _k;
+    std::unique_ptr<std::byte, SlabDeleter> _slab;
+    size_t* _size;
+    size_t* _head;
+    size_t* _tail;
+    K* _bottom;
+    K* _keys;
+    V* _values;
+    [[no_unique_address]] Compare comparator;
+
+    [[nodiscard]] static size_t alignUp(size_t bytes) { return (bytes + slabAlignment - 1) & ~(slabAlignment - 1); }
+
+    /**
+     * @brief Starts an array of count objects at the cursor and advances it by stride bytes.
+     */
+    template<typename T>
+    static T* carve(std::byte*& cursor, size_t count, size_t stride) {
+        auto* array = std::uninitialized_default_construct_n(reinterpret_cast<T*>(cursor), count) - count;
+        cursor += stride;
+        return array;
+    }
+
+    // checked in every build, an out of range query would write into the neighbouring slab arrays
+    void check(size_t query) const {
+        if (query >= _queries) throw std::runtime_error("Query index out of range in BoundedPriorityDequeBatch");
+    }
+
+    // also checked in every build, popping an empty query would wrap its size around
+    void checkNotEmpty(size_t query) const {
+        check(query);
+        if (_size[query] == 0) throw std::runtime_error("Attempted to access empty query of BoundedPriorityDequeBatch");
+    }
+
+    /**
+     * @brief Admission test of admits() and pushAll(), without the query check.
+     *
+     * Every term is evaluated and combined without short-circuiting, a single branch on the verdict remains
+     * at the call site. Comparing against _bottom of a query that is not full is safe, every _bottom slot
+     * holds a valid key from construction on.
+     */
+    [[nodiscard]] bool accepts(size_t query, const K& key) const {
+        return (_k > 0) & ((_size[query] < _k) | comparator(key, _bottom[query]));
+    }
+
+    [[nodiscard]] size_t prevIndex(size_t index) const { return index == 0 ? _k - 1 : index - 1; }
+    [[nodiscard]] size_t nextIndex(size_t index) const { return index + 1 == _k ? 0 : index + 1; }
+
+    /**
+     * @brief Inserts an admitted element, dropping the bottom of a full query first.
+     */
+    void insert(size_t query, const K& key, const V& value) {
+        auto* keys = _keys + query * _k;
+        auto* values = _values + query * _k;
+        auto& head = _head[query];
+        auto& tail = _tail[query];
+        auto& size = _size[query];
+
+        if (size == _k) {
+            tail = prevIndex(tail);
+            --size;
+        }
+
+        size_t slot;
+        if (size == 0) {
+            slot = head = tail = 0;
+        } else if (!comparator(keys[head], key)) {
+            slot = head = prevIndex(head);
+        } else {
+            auto hole = nextIndex(tail), index = tail;
+            tail = hole;
+            while (!comparator(keys[index], key)) {
+                keys[hole] = keys[index];
+                values[hole] = values[index];
+                hole = index;
+                index = prevIndex(index);
+            }
+            slot = hole;
+        }
+
+        keys[slot] = key;
+        values[slot] = value;
+        ++size;
+        _bottom[query] = keys[tail];
+    }
+
+public:
+    /**
+     * @brief Primary constructor, allocates the slab for all queries at once.
+     *
+     * @param queries The number of queries M.
+     * @param capacity The bounding capacity k of every query.
+     * @param comp The comparator instance, only relevant for stateful comparators.
+     */
+    BoundedPriorityDequeBatch(size_t queries, size_t capacity, Compare comp = Compare()) :
+            _queries(queries), _k(capacity), comparator(comp) {
+        auto indexBytes = alignUp(queries * sizeof(size_t)), bottomBytes = alignUp(queries * sizeof(K));
+        auto keyBytes = alignUp(queries * capacity * sizeof(K));
+        auto bytes = 3 * indexBytes + bottomBytes + keyBytes + alignUp(queries * capacity * sizeof(V));
+        _slab.reset(static_cast<std::byte*>(::operator new(std::max<size_t>(bytes, 1), std::align_val_t{ slabAlignment })));
+
+        auto* cursor = _slab.get();
+        _size = carve<size_t>(cursor, queries, indexBytes);
+        _head = carve<size_t>(cursor, queries, indexBytes);
+        _tail = carve<size_t>(cursor, queries, indexBytes);
+        _bottom = carve<K>(cursor, queries, bottomBytes);
+        std::fill_n(_bottom, queries, K());
+        _keys = carve<K>(cursor, queries * capacity, keyBytes);
+        _values = carve<V>(cursor, queries * capacity, 0);
+        clear();
+    }
+
+    BoundedPriorityDequeBatch(BoundedPriorityDequeBatch&&) noexcept = default;
+    BoundedPriorityDequeBatch& operator=(BoundedPriorityDequeBatch&&) noexcept = default;
+
+    /**
+     * @brief Tests a candidate against one query without inserting it.
+     *
+     * @return True if the query is below capacity or the key outranks its bottom element.
+     */
+    [[nodiscard]] bool admits(size_t query, const K& key) const {
+        check(query);
+        return accepts(query, key);
+    }
+
+    /**
+     * @brief Inserts an element into one query if its key is accepted.
+     *
+     * @param query The query index.
+     * @param key The bounding key value.
+     * @param value The value.
+     */
+    void push(size_t query, const K& key, const V& value) {
+        if (admits(query, key)) insert(query, key, value);
+    }
+
+    /**
+     * @brief Offers one candidate to every query, as produced by a batched distance kernel.
+     *
+     * A scalar loop over the queries, each admission test is branch-free and leaves one branch on its verdict,
+     * which is well predicted once most candidates are rejected.
+     *
+     * @param keys One key per query.
+     * @param values One value per query.
+     */
+    void pushAll(std::span<const K> keys, std::span<const V> values) {
+        if (keys.size() != _queries || values.size() != _queries) {
+            throw std::runtime_error("pushAll expects one key and value per query of BoundedPriorityDequeBatch");
+        }
+        for (size_t query = 0; query < _queries; ++query) {
+            if (accepts(query, keys[query])) insert(query, keys[query], values[query]);
+        }
+    }
+
+    /**
+     * @param query The query index.
+     * @param offsetTop The offset from the highest-priority element of the query.
+     * @return A copy of the element offsetTop positions below the top.
+     */
+    [[nodiscard]] value_type element(size_t query, size_t offsetTop) const {
+        checkNotEmpty(query);
+        if (offsetTop >= _size[query]) throw std::runtime_error("Offset out of range in BoundedPriorityDequeBatch");
+        auto index = _head[query] + offsetTop;
+        if (index >= _k) index -= _k;
+        return { _keys[query * _k + index], _values[query * _k + index] };
+    }
+
+    [[nodiscard]] value_type top(size_t query) const { return element(query, 0); }
+
+    [[nodiscard]] value_type bottom(size_t query) const {
+        checkNotEmpty(query);
+        return { _keys[query * _k + _tail[query]], _values[query * _k + _tail[query]] };
+    }
+
+    [[nodiscard]] K topK(size_t query) const { return top(query).key; }
+    [[nodiscard]] K bottomK(size_t query) const { return bottom(query).key; }
+
+    /**
+     * @brief The key a candidate must outrank to enter a query, see BoundedPriorityDequeBase::threshold().
+     */
+    [[nodiscard]] K threshold(size_t query) const requires is_builtin_ordering_v<Compare, K> {
+        check(query);
+        constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+        using limits = std::numeric_limits<K>;
+        constexpr K highest = limits::has_infinity ? limits::infinity() : limits::max();
+        constexpr K lowest = limits::has_infinity ? -limits::infinity() : limits::lowest();
+        if (_k == 0) return ascending ? lowest : highest;
+        if (_size[query] == _k) return _bottom[query];
+        return ascending ? highest : lowest;
+    }
+
+    /**
+     * @brief remove the highest-priority element of a query.
+     *
+     * @return The removed highest-priority element.
+     */
+    value_type pop(size_t query) {
+        auto element = top(query);
+        _head[query] = nextIndex(_head[query]);
+        --_size[query];
+        return element;
+    }
+
+    /**
+     * @brief Empties a single query.
+     */
+    void clear(size_t query) {
+        check(query);
+        _size[query] = _head[query] = _tail[query] = 0;
+    }
+
+    /**
+     * @brief Empties every query.
+     */
+    void clear() {
+        std::fill_n(_size, _queries, 0);
+        std::fill_n(_head, _queries, 0);
+        std::fill_n(_tail, _queries, 0);
+    }
+
+    [[nodiscard]] size_t queries() const { return _queries; }
+    [[nodiscard]] size_t capacity() const { return _k; }
+    [[nodiscard]] size_t size(size_t query) const { check(query); return _size[query]; }
+    [[nodiscard]] bool empty(size_t query) const { return size(query) == 0; }
+    [[nodiscard]] bool full(size_t query) const { return size(query) == _k; }
 };
 
 /**
- * @class BoundedMinPriorityDeque
- * @brief Lightweight minimum priority dequeue
+ * @class BoundedPriorityDequeView
+ * @brief Read-only deque over a DequeSnapshot record in place, for instance in a memory-mapped file.
  *
- * This class provides a lightweight minimum priority implement of the base class with an arithmetic key value.
+ * Nothing is copied or rebuilt, the keys and values are read straight from the record, so opening a view
+ * costs a header read and every access after that at most a page fault. The record has to stay mapped and
+ * unmodified for the lifetime of the view and start at a multiple of DequeSnapshot::alignment.
  *
- * @tparam K Arithmetic type of the key.
+ * @tparam K Type of the key.
  * @tparam V Type of the value.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b', only used by threshold().
  */
-template<typename K, typename V>
-class BoundedMinPriorityDeque : public BoundedPriorityDequeBase<K, V> {
-protected:
-    [[nodiscard]] bool compare(K a, K b) const override { return a < b; }
+template<typename K, typename V, typename Compare = std::less<K>>
+requires DequeSnapshot::supports<K, V>
+class BoundedPriorityDequeView {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = BoundingPair<K, V>;
+    using key_compare = Compare;
+    using const_reference = BoundingPair<const K&, const V&>;
+
+private:
+    const K* _keys;
+    const V* _values;
+    size_t _k, _size;
 
 public:
-    explicit BoundedMinPriorityDeque(unsigned int capacity = 0) : BoundedPriorityDequeBase<K, V>(capacity) {}
+    /**
+     * @param record The record, further records may follow it.
+     */
+    explicit BoundedPriorityDequeView(std::span<const std::byte> record) {
+        if (reinterpret_cast<uintptr_t>(record.data()) % DequeSnapshot::alignment != 0) {
+            throw std::runtime_error("Misaligned BoundedPriorityDeque snapshot");
+        }
+        auto header = DequeSnapshot::header<K, V>(record);
+        _k = static_cast<size_t>(header.capacity);
+        _size = static_cast<size_t>(header.size);
+        _keys = reinterpret_cast<const K*>(record.data() + sizeof(header));
+        _values = reinterpret_cast<const V*>(record.data() + DequeSnapshot::valueOffset<K, V>(_size));
+    }
+
+    /**
+     * @param offsetTop The offset from the highest-priority element.
+     * @return The element offsetTop positions below the top.
+     */
+    const_reference operator[](size_t offsetTop) const { return { _keys[offsetTop], _values[offsetTop] }; }
+
+    const_reference top() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access top element of empty BoundedPriorityDequeView");
+#endif
+        return (*this)[0];
+    }
+
+    const_reference bottom() const {
+#ifdef ENABLE_DEBUG
+        if (empty()) throw std::runtime_error("Attempted to access bottom element of empty BoundedPriorityDequeView");
+#endif
+        return (*this)[_size - 1];
+    }
+
+    [[nodiscard]] K topK() const { return top().key; }
+    [[nodiscard]] K bottomK() const { return bottom().key; }
+
+    /**
+     * @brief The key a candidate must outrank to be accepted, see BoundedPriorityDequeBase::threshold().
+     */
+    [[nodiscard]] K threshold() const requires is_builtin_ordering_v<Compare, K> {
+        constexpr bool ascending = std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+        using limits = std::numeric_limits<K>;
+        constexpr K highest = limits::has_infinity ? limits::infinity() : limits::max();
+        constexpr K lowest = limits::has_infinity ? -limits::infinity() : limits::lowest();
+        if (full()) return _k == 0 ? (ascending ? lowest : highest) : bottomK();
+        return ascending ? highest : lowest;
+    }
+
+    /**
+     * @return The keys in priority order.
+     */
+    [[nodiscard]] std::span<const K> keys() const { return { _keys, _size }; }
+
+    /**
+     * @return The values in priority order.
+     */
+    [[nodiscard]] std::span<const V> values() const { return { _values, _size }; }
+
+    /**
+     * @return The size of the viewed record, the offset of the next record.
+     */
+    [[nodiscard]] size_t serializedSize() const { return DequeSnapshot::bytes<K, V>(_size); }
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] size_t capacity() const { return _k; }
+    [[nodiscard]] bool empty() const { return _size == 0; }
+    [[nodiscard]] bool full() const { return _size == _k; }
 };
 
 /**
- * @class BoundedMaxPriorityDeque
- * @brief Lightweight maximum priority dequeue
+ * @brief A small per-thread ticket, handed out in order of first use.
  *
- * This class provides a lightweight maximum priority implement of the base class with an arithmetic key value.
+ * Used to spread threads over the staging deques of the concurrent collectors.
  *
- * @tparam K Arithmetic type of the key.
- * @tparam V Type of the value.
+ * @return The ticket of the calling thread.
  */
-template<typename K, typename V>
-class BoundedMaxPriorityDeque : public BoundedPriorityDequeBase<K, V> {
-protected:
-    [[nodiscard]] bool compare(K a, K b) const override { return a > b; }
+inline size_t threadTicket() {
+    static std::atomic<size_t> tickets = 0;
+    thread_local size_t ticket = tickets.fetch_add(1, std::memory_order_relaxed);
+    return ticket;
+}
+
+/**
+ * @class SharedThreshold
+ * @brief Monotonically tightening acceptance bound shared between the threads filling one top-k.
+ *
+ * The bottom key of any full deque holding candidates of the collection is a valid bound for the global top-k,
+ * the best bound seen so far is published atomically. Lives on its own cache line, it is read on every push.
+ *
+ * @tparam K Type of the key, trivially copyable with an always lock-free std::atomic<K>.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ */
+template<typename K, typename Compare>
+class alignas(64) SharedThreshold {
+    static_assert(std::is_trivially_copyable_v<K>, "keys are published through std::atomic<K>");
+    static_assert(std::atomic<K>::is_always_lock_free, "std::atomic<K> must be lock-free for the threshold fast path");
+
+    std::atomic<K> _bound;
+    std::atomic<bool> _bounded = false, _publishing = false;
+    [[no_unique_address]] Compare comparator;
 
 public:
-    explicit BoundedMaxPriorityDeque(unsigned int capacity = 0) : BoundedPriorityDequeBase<K, V>(capacity) {}
+    explicit SharedThreshold(Compare comp = Compare()) : comparator(comp) {}
+
+    /**
+     * @brief Tightens the threshold to the given bound if it is an improvement.
+     *
+     * The first bound is claimed by a single thread, a thread losing that race drops its bound, which only
+     * delays the pruning, never breaks it.
+     *
+     * @param bound The bottom key of a full deque holding candidates of this collection.
+     */
+    void publish(const K& bound) {
+        if (!_bounded.load(std::memory_order_acquire)) {
+            if (_publishing.exchange(true, std::memory_order_relaxed)) return;
+            _bound.store(bound, std::memory_order_relaxed);
+            _bounded.store(true, std::memory_order_release);
+            return;
+        }
+        auto current = _bound.load(std::memory_order_relaxed);
+        while (comparator(bound, current) && !_bound.compare_exchange_weak(current, bound, std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * @brief Lock-free check against the published bound.
+     *
+     * Only keys strictly behind the bound are rejected. A key equal to it may still win a tie in the final merge,
+     * dropping it would make the outcome of that tie depend on which thread published first.
+     *
+     * @param key The key of a candidate element.
+     * @return True if the candidate can not make it into the top-k, false if it may.
+     */
+    [[nodiscard]] bool rejects(const K& key) const {
+        return _bounded.load(std::memory_order_acquire) && comparator(_bound.load(std::memory_order_relaxed), key);
+    }
+
+    /**
+     * @brief Forgets the bound, must not overlap with publish().
+     */
+    void reset() {
+        _bounded.store(false, std::memory_order_relaxed);
+        _publishing.store(false, std::memory_order_relaxed);
+    }
 };
 
 /**
- * @class BoundedPriorityDequeKeyed
- * @brief Lightweight custom key comparator priority dequeue
+ * @class ConcurrentBoundedPriorityDeque
+ * @brief Bounded priority deque collecting a shared top-k from many threads without a global lock.
  *
- * This class provides a lightweight custom-comparator implement of the base class.
- * This derived class allows for non-standard or non-arithmetic key types via a custom-comparator template argument.
- * The custom-comparator should be in the form of a function<bool(K a, K b)> comparator which returns
- * true if 'a' has a higher-priority than 'b'.
+ * Every thread pushes into its own staging deque, picked by a per-thread ticket, so producers never touch
+ * each other's data. Each staging deque is guarded by its own flag, only ever contended by a concurrent
+ * collect(). Whenever a staging deque is full its bottom key is a valid bound for the global top-k, the best
+ * of these bounds is published as an atomic threshold, and candidates that do not outrank it are rejected
+ * with a single atomic load before any locking happens. The staging deques are merged lazily on read.
  *
- * @tparam K Template-comparator compatible key Type.
+ * With at most shards() producer threads no two producers share a staging deque, surplus threads share
+ * them round-robin and stay correct, just no longer uncontended.
+ *
+ * @tparam K Type of the key, trivially copyable with an always lock-free std::atomic<K>, see SharedThreshold.
  * @tparam V Type of the value.
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @tparam CapacityPolicy Physical buffer sizing and index wrapping, ExactCapacity or Pow2Capacity.
+ * @tparam Layout Slot storage layout, InterleavedLayout or SplitLayout.
+ * @tparam SearchPolicy Insertion offset search beyond rankSearchLimit, BinarySearch or BranchlessSearch.
+ * @tparam TiePolicy Placement of equal keys, LifoTies or StableTies.
  */
-template<typename K, typename V, typename Comparator = std::less<K>>
-class BoundedPriorityDequeKeyed : public BoundedPriorityDequeBase<K, V> {
-protected:
-    Comparator comparator;
+template<typename K, typename V, typename Compare = std::less<K>, typename CapacityPolicy = ExactCapacity,
+         typename Layout = InterleavedLayout, typename SearchPolicy = BinarySearch, typename TiePolicy = LifoTies>
+class ConcurrentBoundedPriorityDeque {
+public:
+    using Deque = BoundedPriorityDequeBase<K, V, Compare, CapacityPolicy, Layout, SearchPolicy, TiePolicy>;
+
+private:
+    struct alignas(64) Shard {
+        mutable std::atomic_flag busy;
+        Deque deque;
+
+        void lock() const {
+            while (busy.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+        }
+
+        void unlock() const { busy.clear(std::memory_order_release); }
+    };
 
-    [[nodiscard]] bool compare(K a, K b) const override { return comparator(a, b); }
+    size_t _k, _shardCount;
+    std::unique_ptr<Shard[]> _shards;
+    mutable SharedThreshold<K, Compare> _threshold;
+    [[no_unique_address]] Compare comparator;
 
 public:
-    explicit BoundedPriorityDequeKeyed(unsigned int capacity = 0, Comparator comp = Comparator()) :
-            BoundedPriorityDequeBase<K, V>(capacity), comparator(comp) {}
+    /**
+     * @brief Primary constructor.
+     *
+     * @param capacity The bounding capacity of the collected top-k.
+     * @param shards Number of staging deques, defaults to the hardware concurrency.
+     * @param comp The comparator instance, only relevant for stateful comparators.
+     */
+    explicit ConcurrentBoundedPriorityDeque(size_t capacity, size_t shards = std::thread::hardware_concurrency(),
+                                            Compare comp = Compare()) :
+            _k(capacity), _shardCount(std::max<size_t>(shards, 1)),
+            _shards(std::make_unique<Shard[]>(_shardCount)), _threshold(comp), comparator(comp) {
+        for (size_t i = 0; i < _shardCount; ++i) _shards[i].deque = Deque(capacity, comp);
+    }
+
+    /**
+     * @brief Lock-free check against the published threshold.
+     *
+     * @param key The key of a candidate element.
+     * @return True if the candidate can not make it into the top-k, false if it may.
+     */
+    [[nodiscard]] bool rejects(const K& key) const {
+        return _k == 0 || _threshold.rejects(key);
+    }
+
+    /**
+     * @brief constructs an element in the calling threads staging deque, see BoundedPriorityDequeBase::emplace().
+     *
+     * Safe to call from any number of threads concurrently.
+     *
+     * @param key The bounding key value
+     * @param args The value, or the arguments forwarded to the value constructor.
+     */
+    template<typename... Args>
+    void emplace(const K& key, Args&&... args) {
+        if (rejects(key)) return;
+        auto& shard = _shards[threadTicket() % _shardCount];
+        shard.lock();
+        shard.deque.emplace(key, std::forward<Args>(args)...);
+        if (shard.deque.full()) _threshold.publish(shard.deque.bottomK());
+        shard.unlock();
+    }
+
+    /**
+     * @brief Inserts an element from any thread, see emplace().
+     *
+     * @param element The element to be inserted.
+     */
+    void push(const BoundingPair<K, V>& element) { emplace(element.key, element.value); }
+
+    /**
+     * @brief Inserts an element from any thread, moving its value into place.
+     *
+     * @param element The element to be inserted.
+     */
+    void push(BoundingPair<K, V>&& element) { emplace(element.key, std::move(element.value)); }
+
+    /**
+     * @brief Merges the staging deques into the current top-k.
+     *
+     * May run concurrently with pushes, each staging deque is locked only while it is merged, so elements
+     * pushed meanwhile may or may not be part of the result. A full result tightens the published threshold.
+     *
+     * @return The collected top-k.
+     */
+    [[nodiscard]] Deque collect() const {
+        Deque result(_k, comparator);
+        for (size_t i = 0; i < _shardCount; ++i) {
+            _shards[i].lock();
+            result += _shards[i].deque;
+            _shards[i].unlock();
+        }
+        if (_k > 0 && result.full()) _threshold.publish(result.bottomK());
+        return result;
+    }
+
+    /**
+     * @brief Empties every staging deque and forgets the threshold, must not overlap with pushes.
+     */
+    void clear() {
+        for (size_t i = 0; i < _shardCount; ++i) _shards[i].deque.clear();
+        _threshold.reset();
+    }
+
+    /**
+     *
+     * @return The bounding capacity of the collected top-k.
+     */
+    [[nodiscard]] size_t capacity() const { return _k; }
+
+    /**
+     *
+     * @return The number of staging deques.
+     */
+    [[nodiscard]] size_t shards() const { return _shardCount; }
 };
 
 /**
- * @class BoundedPriorityDeque
- * @brief Lightweight custom value-based comparator priority dequeue
- *
- * This derived class enables comparison on a value objects internal state with a comparator.
- *
- * The addition of a comparisonValue() allows for a key to be extracted from the value objects internal structure.
+ * @class ShardedBoundedPriorityDeque
+ * @brief One deque per thread or shard index, reduced into a single top-k with a deterministic k-way merge.
  *
- * ex. for double:  [[nodiscard]] double comparisonValue(const Edge& edge) const { return edge.distance; }
+ * Shards are cache line aligned so threads filling neighbouring shards never false share. Writes through
+ * a Local handle prune against a SharedThreshold that tightens monotonically as shards fill, and publish
+ * their own bottom key whenever their shard is full.
  *
- * The custom-comparator should be in the form of a function<bool(K a, K b)> comparator which returns
- * true if 'a' has a higher-priority than 'b'.
+ * There is no locking, each shard must be written by one thread at a time and collect() must not overlap with
+ * writers. collect() merges the shards in index order with mergeAll(), so equal keys resolve by shard index.
+ * The threshold only prunes keys strictly behind it, which never reach the result, so whichever shard elements
+ * can reach the result does not depend on the timing of the other shards: pinning work to shards through
+ * local(shard) gives identical results on every run.
  *
- * @tparam K Template-comparator compatible key Type.
- * @tparam V Type of the value.
+ * @tparam Deque The per-shard deque type, BoundedPriorityDequeBase or a derived deque, keyed as SharedThreshold requires.
  */
-template<typename V, typename Comparator, typename K = decltype(std::declval<Comparator>().comparisonValue(std::declval<V>()))>
-class BoundedPriorityDeque : public BoundedPriorityDequeBase<K, V> {
-protected:
-    Comparator comparator;
+template<typename Deque>
+class ShardedBoundedPriorityDeque {
+public:
+    using K = typename Deque::key_type;
+    using V = typename Deque::mapped_type;
+
+private:
+    struct alignas(64) Shard {
+        Deque deque;
+    };
+
+    size_t _k, _shardCount;
+    std::unique_ptr<Shard[]> _shards;
+    SharedThreshold<K, typename Deque::key_compare> _threshold;
+
+public:
+    /**
+     * @class Local
+     * @brief Writer handle for a single shard, pruning against the shared threshold.
+     */
+    class Local {
+        Deque& _deque;
+        SharedThreshold<K, typename Deque::key_compare>& _threshold;
 
-    [[nodiscard]] bool compare(K a, K b) const override {
-        return comparator(a, b);
+    public:
+        Local(Deque& deque, SharedThreshold<K, typename Deque::key_compare>& threshold) :
+                _deque(deque), _threshold(threshold) {}
+
+        /**
+         * @param key The key of a candidate element.
+         * @return True if the candidate can not make it into the collected top-k.
+         */
+        [[nodiscard]] bool rejects(const K& key) const { return _threshold.rejects(key); }
+
+        /**
+         * @brief constructs an element in the shard, see BoundedPriorityDequeBase::emplace().
+         *
+         * @param key The bounding key value
+         * @param args The value, or the arguments forwarded to the value constructor.
+         */
+        template<typename... Args>
+        void emplace(const K& key, Args&&... args) {
+            if (_threshold.rejects(key)) return;
+            static_cast<typename Deque::Base&>(_deque).emplace(key, std::forward<Args>(args)...);
+            if (_deque.full() && !_deque.empty()) _threshold.publish(_deque.bottomK());
+        }
+
+        void push(const BoundingPair<K, V>& element) { emplace(element.key, element.value); }
+
+        void push(BoundingPair<K, V>&& element) { emplace(element.key, std::move(element.value)); }
+
+        /**
+         * @return The shard itself, writes made directly do not tighten the shared threshold.
+         */
+        Deque& deque() { return _deque; }
+    };
+
+    /**
+     * @brief Primary constructor.
+     *
+     * @param capacity The bounding capacity of every shard and of the collected top-k.
+     * @param shards Number of shards, defaults to the hardware concurrency.
+     */
+    explicit ShardedBoundedPriorityDeque(size_t capacity, size_t shards = std::thread::hardware_concurrency()) :
+            _k(capacity), _shardCount(std::max<size_t>(shards, 1)), _shards(std::make_unique<Shard[]>(_shardCount)) {
+        for (size_t i = 0; i < _shardCount; ++i) _shards[i].deque = Deque(capacity);
     }
 
-    K extractKey(const V& value) const {
-        return comparator.comparisonValue(value);
+    /**
+     * @param shard The shard index, less than shards().
+     * @return A writer handle for the given shard.
+     */
+    [[nodiscard]] Local local(size_t shard) {
+#ifdef ENABLE_DEBUG
+        if (shard >= _shardCount) throw std::runtime_error("Shard index out of range in ShardedBoundedPriorityDeque");
+#endif
+        return { _shards[shard].deque, _threshold };
     }
 
-public:
-    explicit BoundedPriorityDeque(unsigned int capacity = 0, Comparator comp = Comparator()) :
-            BoundedPriorityDequeBase<K, V>(capacity), comparator(comp) {}
+    /**
+     * @return A writer handle for the shard of the calling thread, threads beyond shards() wrap around.
+     */
+    [[nodiscard]] Local local() { return local(threadTicket() % _shardCount); }
 
-    void emplace(const V& value) {
-        K key = extractKey(value);
-        BoundedPriorityDequeBase<K, V>::emplace(key, value);
+    /**
+     * @brief Reduces the shards into the collected top-k, see mergeAll().
+     *
+     * A full result tightens the shared threshold for any further rounds.
+     *
+     * @return The collected top-k.
+     */
+    [[nodiscard]] Deque collect() {
+        std::vector<const typename Deque::Base*> deques(_shardCount);
+        for (size_t i = 0; i < _shardCount; ++i) deques[i] = &_shards[i].deque;
+
+        Deque result(_k);
+        Deque::mergeAll(deques, result);
+        if (_k > 0 && result.full()) _threshold.publish(result.bottomK());
+        return result;
+    }
+
+    /**
+     * @brief Empties every shard and forgets the shared threshold.
+     */
+    void clear() {
+        for (size_t i = 0; i < _shardCount; ++i) _shards[i].deque.clear();
+        _threshold.reset();
     }
 
-    void push(const V& value) { emplace(value); }
+    /**
+     *
+     * @return The bounding capacity of the collected top-k.
+     */
+    [[nodiscard]] size_t capacity() const { return _k; }
+
+    /**
+     *
+     * @return The number of shards.
+     */
+    [[nodiscard]] size_t shards() const { return _shardCount; }
 };
 
+/**
+ * @brief Inputs shorter than this many elements per task are split over fewer tasks by parallelTopK().
+ *
+ * Below it the fixed cost of scheduling a task and merging its deque outweighs the pushes it takes over.
+ */
+inline constexpr size_t parallelTopKGrain = 4096;
+
+/**
+ * @brief The deque returned by parallelTopK(), holding copies of the range elements keyed by keyFn.
+ */
+template<typename Range, typename KeyFn, typename Compare = std::less<>>
+using ParallelTopKDeque = BoundedPriorityDequeBase<
+        std::remove_cvref_t<std::invoke_result_t<KeyFn&, std::ranges::range_reference_t<Range>>>,
+        std::ranges::range_value_t<Range>, Compare>;
+
+/**
+ * @brief Collects the top-k of a range on an executor without blocking, delivering the result to a callback.
+ *
+ * The range is cut into contiguous chunks, one task per chunk, and every task fills its own shard of a
+ * ShardedBoundedPriorityDeque, pruning against the shared threshold as soon as any shard is full. The task
+ * finishing last reduces the shards with the k-way mergeAll() and invokes done on its own thread, so neither
+ * the caller nor a worker ever waits. This is the hook for asynchronous pipelines: resuming a coroutine or
+ * completing a sender from done needs no further support from the deque.
+ *
+ * The executor is any callable taking a nullary task, a thread pool submit for example, it may run the
+ * task inline. An exception thrown by keyFn or by the executor itself is passed to done instead of a result.
+ * An lvalue range must stay alive until done has been invoked. Keys equal to the k-th key resolve by chunk order, so
+ * every run returns the same result.
+ *
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @param range A random access range of the candidates.
+ * @param k The bounding capacity of the top-k.
+ * @param keyFn Maps a candidate to its key, invoked concurrently from every task.
+ * @param executor Schedules a nullary task, executor(task).
+ * @param done Invoked once as done(std::exception_ptr error, ParallelTopKDeque&& result).
+ * @param tasks Upper bound on the number of tasks, defaults to the hardware concurrency.
+ */
+template<typename Compare = std::less<>, std::ranges::random_access_range Range, typename KeyFn, typename Executor,
+         typename Done>
+    requires std::ranges::sized_range<Range> && (std::is_lvalue_reference_v<Range> || std::ranges::borrowed_range<Range>)
+void parallelTopKAsync(Range&& range, size_t k, KeyFn keyFn, Executor&& executor, Done done,
+                       size_t tasks = std::thread::hardware_concurrency()) {
+    using Deque = ParallelTopKDeque<Range, KeyFn, Compare>;
+
+    struct State {
+        ShardedBoundedPriorityDeque<Deque> sharded;
+        std::ranges::iterator_t<Range> first;
+        size_t count, chunks;
+        KeyFn keyFn;
+        Done done;
+        std::atomic<size_t> pending;
+        std::atomic_flag failed;
+        std::exception_ptr error;
+
+        State(Range& range, size_t k, size_t chunks, KeyFn&& keyFn, Done&& done) :
+                sharded(k, chunks), first(std::ranges::begin(range)), count(std::ranges::size(range)), chunks(chunks),
+                keyFn(std::move(keyFn)), done(std::move(done)), pending(chunks) {}
+
+        void fail() {
+            if (!failed.test_and_set(std::memory_order_acq_rel)) error = std::current_exception();
+        }
+
+        void fill(size_t chunk) {
+            auto local = sharded.local(chunk);
+            auto it = first + static_cast<std::ptrdiff_t>(count * chunk / chunks);
+            auto last = first + static_cast<std::ptrdiff_t>(count * (chunk + 1) / chunks);
+            for (; it != last; ++it) {
+                decltype(auto) element = *it;
+                local.emplace(std::invoke(keyFn, element), element);
+            }
+        }
+
+        // the acq_rel countdown orders every shard write and the error before the reduction on the last thread
+        void finish(size_t finished) {
+            if (pending.fetch_sub(finished, std::memory_order_acq_rel) != finished) return;
+            Deque result(0);
+            if (!failed.test(std::memory_order_acquire)) {
+                try {
+                    result = sharded.collect();
+                } catch (...) {
+                    fail();
+                }
+            }
+            done(error, std::move(result));
+        }
+    };
+
+    auto count = static_cast<size_t>(std::ranges::size(range));
+    auto chunks = std::clamp<size_t>((count + parallelTopKGrain - 1) / parallelTopKGrain, 1, std::max<size_t>(tasks, 1));
+    auto state = std::make_shared<State>(range, k, chunks, std::move(keyFn), std::move(done));
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        try {
+            executor([state, chunk] {
+                try {
+                    state->fill(chunk);
+                } catch (...) {
+                    state->fail();
+                }
+                state->finish(1);
+            });
+        } catch (...) {
+            // chunks never scheduled will not count down on their own
+            state->fail();
+            state->finish(chunks - chunk);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Collects the top-k of a range on an executor, blocking until the result is reduced.
+ *
+ * See parallelTopKAsync(). Must not be called from a task of a single threaded executor, which would wait
+ * on work queued behind itself, exceptions from keyFn or the executor are rethrown here.
+ *
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @param range A random access range of the candidates.
+ * @param k The bounding capacity of the top-k.
+ * @param keyFn Maps a candidate to its key, invoked concurrently from every task.
+ * @param executor Schedules a nullary task, executor(task).
+ * @param tasks Upper bound on the number of tasks, defaults to the hardware concurrency.
+ * @return The top-k of the range.
+ */
+template<typename Compare = std::less<>, std::ranges::random_access_range Range, typename KeyFn, typename Executor>
+    requires std::ranges::sized_range<Range>
+ParallelTopKDeque<Range, KeyFn, Compare> parallelTopK(Range&& range, size_t k, KeyFn keyFn, Executor&& executor,
+                                                      size_t tasks = std::thread::hardware_concurrency()) {
+    std::promise<ParallelTopKDeque<Range, KeyFn, Compare>> reduced;
+    auto result = reduced.get_future();
+    parallelTopKAsync<Compare>(range, k, std::move(keyFn), executor,
+                               [reduced = std::move(reduced)](std::exception_ptr error, auto&& deque) mutable {
+        if (error) reduced.set_exception(error);
+        else reduced.set_value(std::move(deque));
+    }, tasks);
+    return result.get();
+}
+
+/**
+ * @brief Collects the top-k of a range on one std::jthread per chunk, see parallelTopK().
+ *
+ * @tparam Compare Comparator returning true if 'a' has a higher-priority than 'b'.
+ * @param range A random access range of the candidates.
+ * @param k The bounding capacity of the top-k.
+ * @param keyFn Maps a candidate to its key, invoked concurrently from every thread.
+ * @return The top-k of the range.
+ */
+template<typename Compare = std::less<>, std::ranges::random_access_range Range, typename KeyFn>
+    requires std::ranges::sized_range<Range>
+ParallelTopKDeque<Range, KeyFn, Compare> parallelTopK(Range&& range, size_t k, KeyFn keyFn) {
+    std::vector<std::jthread> threads;
+    return parallelTopK<Compare>(range, k, std::move(keyFn), [&threads](auto task) { threads.emplace_back(std::move(task)); });
+}
+
 #endif // BOUNDED_PRIORITY_DEQUE_H
@@ -3,10 +3,18 @@
 //
 
 #include <gtest/gtest.h>
+#include <array>
 #include <thread>
 #include <random>
+#include <string>
 #include <vector>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <ranges>
 #include <algorithm>
+#include <memory_resource>
 #include "include/BoundedPriorityDeque.hpp"
 
 TEST(BoundingPairTest, Comparison) {
@@ -111,6 +119,118 @@ TEST(BoundedDequeTest, Merge) {
     ASSERT_TRUE(a.empty());
 }
 
+TEST(BoundedDequeTest, MergeWrapped) {
+    BoundedMinPriorityDeque<int, std::string, Pow2Capacity> a(5), b(5);
+    for (int key : { 10, 20, 30, 40, 50 }) a.emplace(key, std::to_string(key));
+    a.pop();
+    a.pop();
+    a.emplace(60, "60");
+    for (int key : { 5, 35, 45, 70 }) b.emplace(key, std::to_string(key));
+
+    a += b;
+    ASSERT_EQ(a.size(), 5);
+    for (int key : { 5, 30, 35, 40, 45 }) ASSERT_EQ(a.pop().value, std::to_string(key));
+    ASSERT_EQ(b.size(), 4);
+}
+
+TEST(BoundedDequeTest, MergeEarlyExitAndSelf) {
+    BoundedMaxPriorityDeque<int, int> a(3), b(3);
+    for (int key : { 9, 8, 7 }) a.emplace(key, key);
+    for (int key : { 3, 2, 1 }) b.emplace(key, key);
+
+    a += b;
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(a.bottomK(), 7);
+
+    b += b;
+    ASSERT_EQ(b.size(), 3);
+    for (int key : { 3, 3, 2 }) ASSERT_EQ(b.pop().key, key);
+}
+
+TEST(BoundedDequeTest, MergeMove) {
+    BoundedMinPriorityDeque<int, std::vector<int>> a(4), b(4);
+    a.emplace(2, std::vector<int>(8, 2));
+    a.emplace(4, std::vector<int>(8, 4));
+    b.emplace(1, std::vector<int>(8, 1));
+    b.emplace(3, std::vector<int>(8, 3));
+    b.emplace(5, std::vector<int>(8, 5));
+
+    a += std::move(b);
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(a.size(), 4);
+    for (int key : { 1, 2, 3, 4 }) {
+        auto element = a.pop();
+        ASSERT_EQ(element.key, key);
+        ASSERT_EQ(element.value, std::vector<int>(8, key));
+    }
+}
+
+TEST(BoundedDequeTest, MergeRandomizedAgainstReference) {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(0, 100);
+    for (size_t k : { 1, 2, 5, 16, 31 }) {
+        for (int round = 0; round < 50; ++round) {
+            BoundedMinPriorityDeque<int, int> a(k), b(k);
+            std::vector<int> reference;
+            for (int i = distribution(generator) % 40; i > 0; --i) {
+                int key = distribution(generator);
+                a.emplace(key, key);
+                if (i % 3 == 0) a.pop();
+            }
+            for (int i = distribution(generator) % 40; i > 0; --i) b.emplace(distribution(generator), 0);
+            for (size_t i = 0; i < a.size(); ++i) reference.push_back(a[i].key);
+            for (size_t i = 0; i < b.size(); ++i) reference.push_back(b[i].key);
+            std::sort(reference.begin(), reference.end());
+            reference.resize(std::min(reference.size(), k));
+
+            a += b;
+            ASSERT_EQ(a.size(), reference.size());
+            for (size_t i = 0; i < reference.size(); ++i) ASSERT_EQ(a[i].key, reference[i]);
+        }
+    }
+}
+
+TEST(BoundedDequeTest, MergeAll) {
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> distribution(0, 200);
+    for (size_t k : { 1, 4, 13, 64 }) {
+        std::vector<BoundedMinPriorityDeque<int, int>> locals(9, BoundedMinPriorityDeque<int, int>(k));
+        std::vector<const BoundedPriorityDequeBase<int, int>*> pointers { nullptr };
+        std::vector<int> reference;
+        for (auto& local : locals) {
+            for (int i = distribution(generator) % 80; i > 0; --i) {
+                local.emplace(distribution(generator), 0);
+                if (i % 5 == 0) local.pop();
+            }
+            for (size_t i = 0; i < local.size(); ++i) reference.push_back(local[i].key);
+            pointers.push_back(&local);
+        }
+        std::sort(reference.begin(), reference.end());
+        reference.resize(std::min(reference.size(), k));
+
+        BoundedMinPriorityDeque<int, int> out(k);
+        out.emplace(-1, -1);
+        BoundedPriorityDequeBase<int, int>::mergeAll(pointers, out);
+        ASSERT_EQ(out.size(), reference.size());
+        for (size_t i = 0; i < reference.size(); ++i) ASSERT_EQ(out[i].key, reference[i]);
+    }
+}
+
+TEST(BoundedDequeTest, MergeAllDeterministicTies) {
+    BoundedMaxPriorityDeque<int, std::string> a(2), b(2), out(3);
+    a.emplace(5, "a5");
+    a.emplace(4, "a4");
+    b.emplace(5, "b5");
+    b.emplace(4, "b4");
+
+    std::vector<const BoundedPriorityDequeBase<int, std::string, std::greater<int>>*> pointers { &b, &a };
+    BoundedPriorityDequeBase<int, std::string, std::greater<int>>::mergeAll(pointers, out);
+    ASSERT_EQ(out.pop().value, "b5");
+    ASSERT_EQ(out.pop().value, "a5");
+    ASSERT_EQ(out.pop().value, "b4");
+    ASSERT_TRUE(out.empty());
+}
+
 TEST(BoundedDequeTest, Resize) {
     BoundedMinPriorityDeque<int, std::string> deque(5);
     deque.emplace(2, "two");
@@ -175,22 +295,1151 @@ TEST(BoundedDequeTest, ResizeCircular) {
     ASSERT_TRUE(deque.empty());
 }
 
+template<typename Deque>
+void checkReservedResize() {
+    Deque deque(4);
+    deque.reserve(64);
+    for (int key : { 8, 3, 6, 1, 9, 2 }) deque.emplace(key, std::to_string(key));
+    deque.pop();
+    deque.emplace(0, "0");
+    const auto* top = &deque.top().key;
+
+    std::vector<int> expected = { 0, 2, 3, 6 };
+    for (size_t k : { 2, 48, 64, 3, 1 }) {
+        deque.resize(k);
+        ASSERT_EQ(deque.capacity(), k);
+        ASSERT_EQ(&deque.top().key, top);
+        expected.resize(std::min(expected.size(), k));
+        ASSERT_EQ(deque.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) ASSERT_EQ(deque[i].value, std::to_string(expected[i]));
+
+        for (int key : { 7, 4, 5 }) deque.emplace(key, std::to_string(key));
+        expected.insert(expected.end(), { 4, 5, 7 });
+        std::sort(expected.begin(), expected.end());
+        expected.resize(std::min(expected.size(), k));
+        for (size_t i = 0; i < expected.size(); ++i) ASSERT_EQ(deque[i].key, expected[i]);
+        top = &deque.top().key;
+    }
+
+    deque.resize(100);
+    ASSERT_EQ(deque.capacity(), 100);
+    ASSERT_EQ(deque.topK(), 0);
+    ASSERT_EQ(deque.size(), 1);
+}
+
+TEST(BoundedDequeTest, ReserveAndResizeInPlace) {
+    checkReservedResize<BoundedMinPriorityDeque<int, std::string>>();
+    checkReservedResize<BoundedMinPriorityDeque<int, std::string, Pow2Capacity, SplitLayout>>();
+}
+
+template<typename Deque>
+void checkIterationAndLinearize(size_t k) {
+    static_assert(std::ranges::random_access_range<Deque>);
+    std::mt19937 generator(static_cast<unsigned>(k));
+    std::uniform_int_distribution<int> distribution(0, 1000);
+
+    for (size_t pushes : { size_t(0), k / 2, k, 3 * k }) {
+        Deque deque(k);
+        for (size_t i = 0; i < pushes; ++i) {
+            auto key = distribution(generator);
+            deque.emplace(key, std::to_string(key));
+            if (i % 3 == 0 && deque.size() > 1) deque.discardTop();
+        }
+
+        std::vector<int> order;
+        for (size_t i = 0; i < deque.size(); ++i) order.push_back(deque[i].key);
+        std::vector<int> iterated;
+        for (const auto& element : deque) iterated.push_back(element.key);
+        ASSERT_EQ(iterated, order);
+        ASSERT_EQ(static_cast<size_t>(std::ranges::distance(deque)), deque.size());
+        ASSERT_TRUE(std::ranges::is_sorted(deque, {}, [](const auto& element) { return element.key; }));
+        if (!deque.empty()) {
+            ASSERT_EQ((*(deque.end() - 1)).key, deque.bottomK());
+            ASSERT_EQ(deque.begin()[deque.size() / 2].key, order[deque.size() / 2]);
+        }
+
+        if constexpr (requires { deque.as_spans(); }) {
+            auto [topRun, wrappedRun] = deque.as_spans();
+            ASSERT_EQ(topRun.size() + wrappedRun.size(), deque.size());
+            std::vector<int> spanned;
+            for (const auto& element : topRun) spanned.push_back(element.key);
+            for (const auto& element : wrappedRun) spanned.push_back(element.key);
+            ASSERT_EQ(spanned, order);
+        }
+
+        deque.linearize();
+        iterated.clear();
+        for (const auto& element : deque) {
+            iterated.push_back(element.key);
+            ASSERT_EQ(element.value, std::to_string(element.key));
+        }
+        ASSERT_EQ(iterated, order);
+        if constexpr (requires { deque.as_spans(); }) {
+            ASSERT_EQ(deque.as_spans()[0].size(), deque.size());
+            ASSERT_TRUE(deque.as_spans()[1].empty());
+        }
+
+        deque.emplace(-1, "-1");
+        ASSERT_EQ(deque.topK(), -1);
+    }
+}
+
+TEST(BoundedDequeTest, IteratorsSpansAndLinearize) {
+    for (size_t k : { 1, 2, 5, 16, 37 }) {
+        checkIterationAndLinearize<BoundedMinPriorityDeque<int, std::string>>(k);
+        checkIterationAndLinearize<BoundedMinPriorityDeque<int, std::string, Pow2Capacity, SplitLayout>>(k);
+        checkIterationAndLinearize<StaticBoundedPriorityDeque<int, std::string, 40>>(k);
+    }
+
+    BoundedMinPriorityDeque<int, int> deque(4);
+    for (int key : { 5, 6, 7, 8 }) deque.emplace(key, key);
+    deque.discardTop();
+    deque.discardTop();
+    deque.emplace(9, 9);
+    deque.emplace(1, 1);
+    auto [topRun, wrappedRun] = deque.as_spans();
+    ASSERT_EQ(topRun.size(), 3);
+    ASSERT_EQ(wrappedRun.size(), 1);
+    ASSERT_EQ(wrappedRun[0].key, 9);
+    deque.linearize();
+    std::vector<int> keys;
+    std::ranges::transform(deque, std::back_inserter(keys), &BoundingPair<int, int>::key);
+    ASSERT_EQ(keys, std::vector<int>({ 1, 7, 8, 9 }));
+    ASSERT_EQ(&deque.top(), deque.as_spans()[0].data());
+}
+
+TEST(BoundedDequeTest, StaticDispatch) {
+    static_assert(!std::is_polymorphic_v<BoundedMinPriorityDeque<int, int>>);
+    static_assert(!std::is_polymorphic_v<BoundedMaxPriorityDeque<int, int>>);
+    static_assert(!std::is_polymorphic_v<BoundedPriorityDequeKeyed<int, int, std::greater<>>>);
+    static_assert(sizeof(BoundedMinPriorityDeque<int, int>) == sizeof(BoundedPriorityDequeBase<int, int>));
+}
+
+struct EdgeComparator {
+    bool operator()(double a, double b) const { return a < b; }
+    [[nodiscard]] double comparisonValue(const std::pair<int, double>& edge) const { return edge.second; }
+};
+
+TEST(BoundedDequeTest, ValueComparator) {
+    BoundedPriorityDeque<std::pair<int, double>, EdgeComparator> deque(2);
+    deque.push({ 1, 4.0 });
+    deque.push({ 2, 1.5 });
+    deque.push({ 3, 2.5 });
+
+    ASSERT_EQ(deque.size(), 2);
+    ASSERT_EQ(deque.pop().value.first, 2);
+    ASSERT_EQ(deque.pop().value.first, 3);
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(BoundedDequeTest, InsertIntoWrappedBuffer) {
+    BoundedMinPriorityDeque<int, int> deque(5);
+    for (int key : { 10, 20, 30, 40, 50 }) deque.emplace(key, key);
+    deque.pop();
+    deque.pop();
+    deque.emplace(60, 60);
+    deque.emplace(35, 35);
+    deque.emplace(25, 25);
+
+    for (int key : { 25, 30, 35, 40, 50 }) ASSERT_EQ(deque.pop().key, key);
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(BoundedDequeTest, InsertShiftingTowardsHead) {
+    BoundedMinPriorityDeque<int, int> deque(5);
+    for (int key : { 10, 20, 30 }) deque.emplace(key, key);
+    deque.pop();
+    deque.emplace(25, 25);
+
+    for (int key : { 20, 25, 30 }) ASSERT_EQ(deque.pop().key, key);
+    ASSERT_TRUE(deque.empty());
+}
+
+/**
+ * Pushes random keys interleaved with pops from both ends and checks the deque against a sorted reference.
+ */
+template<typename Deque>
+void checkAgainstReference(size_t k, unsigned int seed) {
+    Deque deque(k);
+    std::vector<int> reference;
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 1000);
+
+    for (int i = 0; i < 5000; ++i) {
+        auto operation = distribution(generator) % 10;
+        if (operation == 0 && !reference.empty()) {
+            ASSERT_EQ(deque.pop().key, reference.front());
+            reference.erase(reference.begin());
+        } else if (operation == 1 && !reference.empty()) {
+            ASSERT_EQ(deque.popBottom().key, reference.back());
+            reference.pop_back();
+        } else {
+            int key = distribution(generator);
+            deque.emplace(key, key);
+            reference.insert(std::upper_bound(reference.begin(), reference.end(), key), key);
+            if (reference.size() > k) reference.pop_back();
+        }
+
+        ASSERT_EQ(deque.size(), reference.size());
+        for (size_t j = 0; j < reference.size(); ++j) ASSERT_EQ(deque[j].key, reference[j]);
+    }
+}
+
+TEST(BoundedDequeTest, RandomizedAgainstReference) {
+    for (size_t k : { 1, 2, 3, 7, 16, 33 }) {
+        checkAgainstReference<BoundedMinPriorityDeque<int, int>>(k, k);
+        checkAgainstReference<BoundedMinPriorityDeque<int, int, Pow2Capacity>>(k, k);
+        checkAgainstReference<BoundedMinPriorityDeque<int, int, ExactCapacity, SplitLayout>>(k, k);
+    }
+}
+
+TEST(BoundedDequeTest, Pow2Capacity) {
+    BoundedMinPriorityDeque<int, std::string, Pow2Capacity> deque(3);
+    ASSERT_EQ(deque.capacity(), 3);
+    deque.emplace(4, "four");
+    deque.emplace(1, "one");
+    deque.emplace(3, "three");
+    deque.emplace(2, "two");
+    ASSERT_TRUE(deque.full());
+    ASSERT_EQ(deque.bottomK(), 3);
+
+    deque.resize(5);
+    ASSERT_EQ(deque.capacity(), 5);
+    deque.emplace(0, "zero");
+    deque.emplace(5, "five");
+    deque.emplace(6, "six");
+    ASSERT_EQ(deque.size(), 5);
+    for (int key : { 0, 1, 2, 3, 5 }) ASSERT_EQ(deque.pop().key, key);
+}
+
+struct CountedValue {
+    static inline int constructions = 0, copies = 0;
+    int payload = 0;
+
+    CountedValue() = default;
+    explicit CountedValue(int payload) : payload(payload) { ++constructions; }
+    CountedValue(const CountedValue& other) : payload(other.payload) { ++copies; }
+    CountedValue(CountedValue&&) noexcept = default;
+    CountedValue& operator=(const CountedValue& other) { payload = other.payload; ++copies; return *this; }
+    CountedValue& operator=(CountedValue&&) noexcept = default;
+
+    static void reset() { constructions = copies = 0; }
+};
+
+TEST(BoundedDequeTest, EmplaceConstructsOnlyAccepted) {
+    BoundedMinPriorityDeque<int, CountedValue> deque(2);
+    CountedValue::reset();
+    deque.emplace(5, 5);
+    deque.emplace(3, 3);
+    deque.emplace(9, 9);
+    deque.emplace(7, 7);
+    deque.emplace(1, 1);
+
+    ASSERT_EQ(CountedValue::constructions, 3);
+    ASSERT_EQ(CountedValue::copies, 0);
+    ASSERT_EQ(deque.top().value.payload, 1);
+    ASSERT_EQ(deque.bottom().value.payload, 3);
+}
+
+TEST(BoundedDequeTest, MovePushAndEmplace) {
+    BoundedMinPriorityDeque<int, CountedValue> deque(3);
+    CountedValue::reset();
+    deque.push(BoundingPair<int, CountedValue>(2, CountedValue(2)));
+    CountedValue value(1);
+    deque.emplace(1, std::move(value));
+    deque.emplace(3, CountedValue(3));
+
+    ASSERT_EQ(CountedValue::copies, 0);
+    ASSERT_EQ(deque.size(), 3);
+
+    BoundedMinPriorityDeque<int, std::vector<int>> vectors(2);
+    std::vector<int> fragment { 1, 2, 3 };
+    vectors.emplace(1, std::move(fragment));
+    vectors.emplace(2, 4, 7);
+    ASSERT_TRUE(fragment.empty());
+    ASSERT_EQ(vectors[0].value, std::vector<int>({ 1, 2, 3 }));
+    ASSERT_EQ(vectors[1].value, std::vector<int>(4, 7));
+}
+
+TEST(BoundedDequeTest, ReferenceAccessorsAndDiscard) {
+    BoundedMinPriorityDeque<int, CountedValue> deque(4);
+    for (int key : { 4, 2, 3, 1 }) deque.emplace(key, key);
+    CountedValue::reset();
+
+    const auto& top = deque.top();
+    ASSERT_EQ(&top, &deque[0]);
+    ASSERT_EQ(&deque.bottom(), &deque[3]);
+    ASSERT_EQ(deque[2].value.payload, 3);
+
+    auto popped = deque.pop();
+    ASSERT_EQ(popped.value.payload, 1);
+    deque.discardTop();
+    deque.discardBottom();
+    ASSERT_EQ(CountedValue::copies, 0);
+    ASSERT_EQ(deque.size(), 1);
+    ASSERT_EQ(deque.top().key, 3);
+    deque.discardBottom();
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(BoundedDequeTest, SplitLayout) {
+    BoundedMaxPriorityDeque<int, std::string, Pow2Capacity, SplitLayout> a(3), b(3);
+    for (int key : { 4, 1, 3, 2 }) a.emplace(key, std::to_string(key));
+    b.emplace(5, "5");
+    b.emplace(0, "0");
+
+    ASSERT_EQ(a.top().key, 4);
+    ASSERT_EQ(a.bottom().value, "2");
+    ASSERT_EQ(a[1].value, "3");
+
+    a += b;
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(a.pop().value, "5");
+    a.resize(1);
+    ASSERT_EQ(a.popBottom().value, "4");
+    ASSERT_TRUE(a.empty());
+}
+
+template<typename Deque, typename K, typename Compare>
+void checkRankSearch(size_t k) {
+    Deque deque(k);
+    std::vector<K> reference;
+    std::mt19937 generator(static_cast<unsigned int>(k));
+    std::uniform_int_distribution<int> distribution(-500, 500);
+    for (int i = 0; i < 2000; ++i) {
+        auto key = static_cast<K>(distribution(generator)) / static_cast<K>(std::is_floating_point_v<K> ? 4 : 1);
+        deque.emplace(key, i);
+        reference.insert(std::upper_bound(reference.begin(), reference.end(), key, Compare()), key);
+        if (reference.size() > k) reference.pop_back();
+        if (i % 7 == 0) {
+            deque.pop();
+            reference.erase(reference.begin());
+        }
+    }
+    ASSERT_EQ(deque.size(), reference.size());
+    for (size_t j = 0; j < reference.size(); ++j) ASSERT_EQ(deque[j].key, reference[j]);
+}
+
+TEST(BoundedDequeTest, RankSearchArithmeticKeys) {
+    static_assert(BoundedMinPriorityDeque<double, int, ExactCapacity, SplitLayout>::rankSearchable);
+    static_assert(!BoundedMinPriorityDeque<double, int>::rankSearchable);
+    for (size_t k : { 3, 17, 64, 65, 200 }) {
+        checkRankSearch<BoundedMinPriorityDeque<double, int, ExactCapacity, SplitLayout>, double, std::less<>>(k);
+        checkRankSearch<BoundedMaxPriorityDeque<float, int, Pow2Capacity, SplitLayout>, float, std::greater<>>(k);
+        checkRankSearch<BoundedMinPriorityDeque<int32_t, int, ExactCapacity, SplitLayout>, int32_t, std::less<>>(k);
+        checkRankSearch<BoundedMaxPriorityDeque<int64_t, int, ExactCapacity, SplitLayout>, int64_t, std::greater<>>(k);
+        checkRankSearch<BoundedMinPriorityDeque<uint16_t, int, ExactCapacity, SplitLayout>, uint16_t, std::less<>>(k);
+    }
+}
+
+TEST(BoundedDequeTest, SearchPolicies) {
+    for (size_t k : { 1, 2, 3, 7, 16, 33, 100, 257 }) {
+        checkAgainstReference<BoundedMinPriorityDeque<int, int, ExactCapacity, InterleavedLayout, BranchlessSearch>>(k, k);
+        checkAgainstReference<BoundedMinPriorityDeque<int, int, Pow2Capacity, SplitLayout, BranchlessSearch>>(k, k);
+        checkAgainstReference<BoundedMinPriorityDeque<int, int, ExactCapacity>>(k, k + 1);
+    }
+    for (size_t k : { 65, 200, 1000 }) {
+        checkRankSearch<BoundedMaxPriorityDeque<double, int, ExactCapacity, SplitLayout, BranchlessSearch>,
+                        double, std::greater<>>(k);
+    }
+}
+
+TEST(BoundedDequeTest, PushAtExtremesAndThreshold) {
+    BoundedMinPriorityDeque<double, int> deque(3);
+    ASSERT_EQ(deque.threshold(), std::numeric_limits<double>::infinity());
+    deque.emplace(5.0, 5);
+    deque.emplace(7.0, 7);
+    deque.emplace(5.0, 50);
+    ASSERT_EQ(deque.threshold(), 7.0);
+    deque.emplace(1.0, 1);
+    deque.emplace(9.0, 9);
+    ASSERT_EQ(deque.threshold(), 5.0);
+    ASSERT_EQ(deque[0].value, 1);
+    ASSERT_EQ(deque[1].value, 50);
+    ASSERT_EQ(deque[2].value, 5);
+
+    BoundedMaxPriorityDeque<int, int> maxDeque(2);
+    ASSERT_EQ(maxDeque.threshold(), std::numeric_limits<int>::lowest());
+    maxDeque.emplace(3, 3);
+    maxDeque.emplace(4, 4);
+    ASSERT_EQ(maxDeque.threshold(), 3);
+    maxDeque.emplace(2, 2);
+    ASSERT_EQ(maxDeque.bottomK(), 3);
+
+    BoundedMinPriorityDeque<double, int> none(0);
+    ASSERT_FALSE(none.threshold() > -std::numeric_limits<double>::infinity());
+}
+
+TEST(BoundedDequeTest, PushRange) {
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> distribution(0, 500);
+    for (size_t k : { 1, 5, 64, 333 }) {
+        for (size_t n : { 0, 3, 100, 5000 }) {
+            std::vector<BoundingPair<int, int>> elements(n);
+            for (auto& element : elements) element = { distribution(generator), distribution(generator) };
+
+            BoundedMinPriorityDeque<int, int> deque(static_cast<unsigned int>(k));
+            std::vector<int> reference;
+            for (int i = 0; i < 40; ++i) {
+                int key = distribution(generator);
+                deque.emplace(key, -1);
+                reference.push_back(key);
+            }
+            deque.pushRange(elements.begin(), elements.end());
+            for (const auto& element : elements) reference.push_back(element.key);
+            std::sort(reference.begin(), reference.end());
+            reference.resize(std::min(reference.size(), k));
+
+            ASSERT_EQ(deque.size(), reference.size());
+            for (size_t j = 0; j < reference.size(); ++j) ASSERT_EQ(deque[j].key, reference[j]);
+        }
+    }
+
+    std::vector<BoundingPair<int, std::string>> words = { { 3, "c" }, { 1, "a" }, { 4, "d" }, { 2, "b" } };
+    BoundedMaxPriorityDeque<int, std::string> deque(3, words.begin(), words.end());
+    ASSERT_EQ(deque.size(), 3);
+    ASSERT_EQ(deque.pop().value, "d");
+    ASSERT_EQ(deque.pop().value, "c");
+    ASSERT_EQ(deque.pop().value, "b");
+
+    BoundedMinPriorityDeque<int, std::string> none(0, words.begin(), words.end());
+    ASSERT_TRUE(none.empty());
+}
+
+/**
+ * Pushes heavily tied keys and checks keys and push order against a stable sort of everything pushed.
+ */
+template<typename Deque>
+void checkStableTies(size_t k) {
+    Deque deque(static_cast<unsigned int>(k)), ranged(static_cast<unsigned int>(k));
+    std::vector<std::pair<typename Deque::key_type, int>> reference;
+    std::vector<BoundingPair<typename Deque::key_type, int>> elements;
+    std::mt19937 generator(static_cast<unsigned int>(k));
+    std::uniform_int_distribution<int> distribution(0, 20);
+    for (int i = 0; i < 3000; ++i) {
+        auto key = static_cast<typename Deque::key_type>(distribution(generator));
+        deque.emplace(key, i);
+        elements.push_back({ key, i });
+        auto position = std::upper_bound(reference.begin(), reference.end(), key,
+                                         [](auto a, const auto& b) { return a < b.first; });
+        reference.insert(position, { key, i });
+        if (reference.size() > k) reference.pop_back();
+    }
+    ranged.pushRange(elements.begin(), elements.end());
+
+    ASSERT_EQ(deque.size(), reference.size());
+    ASSERT_EQ(ranged.size(), reference.size());
+    for (size_t j = 0; j < reference.size(); ++j) {
+        ASSERT_EQ(deque[j].key, reference[j].first);
+        ASSERT_EQ(deque[j].value, reference[j].second);
+        ASSERT_EQ(ranged[j].value, reference[j].second);
+    }
+}
+
+TEST(BoundedDequeTest, StableTies) {
+    for (size_t k : { 1, 4, 31, 64, 200 }) {
+        checkStableTies<BoundedMinPriorityDeque<int, int, ExactCapacity, InterleavedLayout, BinarySearch, StableTies>>(k);
+        checkStableTies<BoundedMinPriorityDeque<int, int, Pow2Capacity, InterleavedLayout, BranchlessSearch, StableTies>>(k);
+        checkStableTies<BoundedMinPriorityDeque<double, int, ExactCapacity, SplitLayout, BinarySearch, StableTies>>(k);
+        checkStableTies<BoundedMinPriorityDeque<int64_t, int, Pow2Capacity, SplitLayout, BinarySearch, StableTies>>(k);
+    }
+    for (size_t k : { 1, 4, 31 }) {
+        checkStableTies<StaticBoundedPriorityDeque<int, int, 32, std::less<int>, InlineInterleavedLayout<32>, BinarySearch,
+                                                   StableTies>>(k);
+    }
+
+    BoundedMaxPriorityDeque<int, std::string, ExactCapacity, InterleavedLayout, BinarySearch, StableTies> a(4), b(4);
+    a.emplace(2, "a2");
+    a.emplace(1, "a1");
+    b.emplace(2, "b2");
+    b.emplace(2, "b2'");
+    a += b;
+    ASSERT_EQ(a[0].value, "a2");
+    ASSERT_EQ(a[1].value, "b2");
+    ASSERT_EQ(a[2].value, "b2'");
+    ASSERT_EQ(a[3].value, "a1");
+    a.emplace(2, "late");
+    ASSERT_EQ(a.bottom().value, "late");
+
+    BoundedPriorityDequeKeyed<std::pair<double, int>, int, std::less<>> byDistanceThenId(2);
+    byDistanceThenId.emplace({ 1.0, 7 }, 0);
+    byDistanceThenId.emplace({ 1.0, 3 }, 0);
+    byDistanceThenId.emplace({ 1.0, 5 }, 0);
+    ASSERT_EQ(byDistanceThenId.topK().second, 3);
+    ASSERT_EQ(byDistanceThenId.bottomK().second, 5);
+}
+
+TEST(BoundedDequeTest, ArenaAllocation) {
+    // the null upstream throws std::bad_alloc the moment anything reaches past the arena
+    std::array<std::byte, 1 << 16> memory;
+    std::pmr::monotonic_buffer_resource arena(memory.data(), memory.size(), std::pmr::null_memory_resource());
+
+    BoundedMinPriorityDeque<int, int, ExactCapacity, PmrInterleavedLayout> deque(8, &arena), other(8, &arena);
+    BoundedMaxPriorityDeque<double, int, Pow2Capacity, PmrSplitLayout> split(5, &arena);
+    ASSERT_EQ(deque.get_allocator().resource(), &arena);
+    for (int i = 0; i < 100; ++i) {
+        deque.emplace(i * 7 % 50, i);
+        other.emplace(i * 3 % 40, i);
+        split.emplace(i * 0.5, i);
+    }
+    deque += other;
+    deque += deque;
+    deque.resize(16);
+    ASSERT_EQ(deque.get_allocator().resource(), &arena);
+
+    std::vector<BoundingPair<int, int>> elements;
+    for (int i = 0; i < 64; ++i) elements.push_back({ -i, i });
+    deque.pushRange(elements.begin(), elements.end());
+
+    const BoundedMinPriorityDeque<int, int, ExactCapacity, PmrInterleavedLayout>::Base* deques[] = { &deque, &other };
+    BoundedMinPriorityDeque<int, int, ExactCapacity, PmrInterleavedLayout> merged(8, &arena);
+    decltype(merged)::mergeAll(deques, merged);
+
+    ASSERT_EQ(deque.size(), 16);
+    ASSERT_EQ(deque.topK(), -63);
+    ASSERT_EQ(merged.topK(), -63);
+    ASSERT_EQ(split.topK(), 49.5);
+
+    std::array<std::byte, 16> small;
+    std::pmr::monotonic_buffer_resource exhausted(small.data(), small.size(), std::pmr::null_memory_resource());
+    ASSERT_THROW((BoundedMinPriorityDeque<int, int, ExactCapacity, PmrInterleavedLayout>(64, &exhausted)), std::bad_alloc);
+}
+
+template<size_t N>
+using NeighborDeque = StaticBoundedPriorityDeque<int, int, N>;
+
+TEST(BoundedDequeTest, StaticInlineStorage) {
+    static_assert(sizeof(NeighborDeque<16>) >= 16 * sizeof(BoundingPair<int, int>));
+    static_assert(std::is_copy_constructible_v<NeighborDeque<16>>);
+    for (size_t k : { 1, 2, 3, 7, 16 }) {
+        checkAgainstReference<NeighborDeque<16>>(k, k);
+        checkAgainstReference<StaticBoundedPriorityDeque<int, int, 33>>(k, k);
+        checkAgainstReference<StaticBoundedPriorityDeque<int, int, 16, std::less<int>, InlineSplitLayout<16>>>(k, k);
+    }
+    checkRankSearch<StaticBoundedPriorityDeque<double, int, 24, std::greater<>, InlineSplitLayout<24>>,
+                    double, std::greater<>>(24);
+
+    NeighborDeque<4> a, b;
+    ASSERT_EQ(a.capacity(), 4);
+    for (int key : { 9, 3, 7, 1, 5 }) a.emplace(key, key);
+    for (int key : { 2, 8, 4 }) b.emplace(key, key);
+    a += b;
+    ASSERT_EQ(a.size(), 4);
+    for (int key : { 1, 2, 3, 4 }) ASSERT_EQ(a.pop().key, key);
+
+    std::vector<BoundingPair<int, int>> elements = { { 6, 0 }, { 2, 0 }, { 4, 0 }, { 8, 0 }, { 0, 0 } };
+    NeighborDeque<3> ranged(elements.begin(), elements.end());
+    ASSERT_EQ(ranged.bottomK(), 4);
+    ranged.resize(2);
+    ASSERT_EQ(ranged.capacity(), 2);
+    ASSERT_EQ(ranged.bottomK(), 2);
+    ASSERT_THROW(ranged.resize(4), std::runtime_error);
+    ASSERT_EQ(ranged.capacity(), 2);
+    ASSERT_EQ(ranged.size(), 2);
+    ranged.resize(3);
+    ASSERT_EQ(ranged.capacity(), 3);
+    ASSERT_THROW(NeighborDeque<3>(4), std::runtime_error);
+
+    // a snapshot of a larger deque does not fit either
+    BoundedMinPriorityDeque<int, int> large(8);
+    for (int key : { 5, 1, 7 }) large.emplace(key, key);
+    alignas(DequeSnapshot::alignment) std::array<std::byte, 256> record {};
+    large.serialize(record);
+    ASSERT_THROW(ranged.deserialize(record), std::runtime_error);
+    ASSERT_EQ(ranged.capacity(), 3);
+    ASSERT_EQ(ranged.topK(), 0);
+}
+
+template<typename Deque>
+constexpr std::array<int, 3> constantBestK() {
+    constexpr std::array<int, 10> keys = { 7, 3, 9, 1, 8, 3, 0, 6, 2, 5 };
+    Deque evens(4), odds(4);
+    for (size_t i = 0; i < keys.size(); ++i) (i % 2 == 0 ? evens : odds).emplace(keys[i], static_cast<int>(i));
+    evens += odds;
+    evens.popBottom();
+    std::array<int, 3> best {};
+    size_t index = 0;
+    for (const auto& element : evens) best[index++] = element.key * 10 + element.value;
+    return best;
+}
+
+// nearest two of a fixed point set for every query in [0, 8), computed entirely at compile time
+constexpr auto nearestTable = [] {
+    constexpr std::array<int, 5> points = { 1, 4, 6, 9, 13 };
+    std::array<std::array<int, 2>, 8> table {};
+    for (int query = 0; query < 8; ++query) {
+        StaticBoundedPriorityDeque<int, int, 2, std::less<int>, InlineInterleavedLayout<2>, BinarySearch, StableTies> nearest;
+        for (int point : points) nearest.emplace(point > query ? point - query : query - point, point);
+        table[query] = { nearest.pop().value, nearest.pop().value };
+    }
+    return table;
+}();
+
+TEST(BoundedDequeTest, ConstantEvaluation) {
+    constexpr std::array<int, 3> expected = { 6, 13, 28 };
+    static_assert(constantBestK<StaticBoundedPriorityDeque<int, int, 4>>() == expected);
+    static_assert(constantBestK<StaticBoundedPriorityDeque<int, int, 4, std::less<int>, InlineSplitLayout<4>>>() == expected);
+    static_assert(constantBestK<StaticBoundedPriorityDeque<int, int, 8, std::less<int>, InlineInterleavedLayout<8>,
+                                                           BranchlessSearch>>() == expected);
+    static_assert(nearestTable[0] == std::array<int, 2> { 1, 4 });
+    static_assert(nearestTable[5] == std::array<int, 2> { 4, 6 });
+    static_assert(nearestTable[7] == std::array<int, 2> { 6, 9 });
+
+    // the same code paths at run time, where rankSearch() and memmove relocation take over
+    ASSERT_EQ((constantBestK<StaticBoundedPriorityDeque<int, int, 4>>()), expected);
+    ASSERT_EQ((constantBestK<StaticBoundedPriorityDeque<int, int, 4, std::less<int>, InlineSplitLayout<4>>>()), expected);
+}
+
+struct LiveValue {
+    static inline int live = 0;
+    std::string payload;
+
+    explicit LiveValue(int payload) : payload(std::to_string(payload)) { ++live; }
+    LiveValue(const LiveValue& other) : payload(other.payload) { ++live; }
+    LiveValue(LiveValue&& other) noexcept : payload(std::move(other.payload)) { ++live; }
+    LiveValue& operator=(const LiveValue&) = default;
+    LiveValue& operator=(LiveValue&&) noexcept = default;
+    ~LiveValue() { --live; }
+};
+
+template<typename Deque>
+void checkLazySlots() {
+    static_assert(!std::is_default_constructible_v<LiveValue>);
+    LiveValue::live = 0;
+    {
+        Deque deque(64);
+        ASSERT_EQ(LiveValue::live, 0);
+        for (int key : { 5, 3, 9, 7, 1, 8, 2 }) deque.emplace(key, key);
+        ASSERT_EQ(LiveValue::live, 7);
+
+        auto copy = deque;
+        ASSERT_EQ(LiveValue::live, 14);
+        copy.resize(3);
+        ASSERT_EQ(LiveValue::live, 10);
+        ASSERT_EQ(copy.bottom().value.payload, "3");
+
+        auto moved = std::move(copy);
+        ASSERT_EQ(LiveValue::live, 10);
+        moved += deque;
+        ASSERT_EQ(LiveValue::live, 10);
+        ASSERT_EQ(moved.pop().value.payload, "1");
+        moved.discardBottom();
+        ASSERT_EQ(LiveValue::live, 8);
+
+        copy = moved;
+        ASSERT_EQ(LiveValue::live, 9);
+        deque.clear();
+        ASSERT_EQ(LiveValue::live, 2);
+        deque.emplace(4, 4);
+        ASSERT_EQ(deque.top().value.payload, "4");
+    }
+    ASSERT_EQ(LiveValue::live, 0);
+}
+
+TEST(BoundedDequeTest, LazySlotConstruction) {
+    checkLazySlots<BoundedMinPriorityDeque<int, LiveValue>>();
+    checkLazySlots<BoundedMinPriorityDeque<int, LiveValue, Pow2Capacity, SplitLayout>>();
+    checkLazySlots<StaticBoundedPriorityDeque<int, LiveValue, 64>>();
+    checkLazySlots<StaticBoundedPriorityDeque<int, LiveValue, 64, std::less<int>, InlineSplitLayout<64>>>();
+
+    std::pmr::monotonic_buffer_resource arena;
+    LiveValue::live = 0;
+    {
+        BoundedMinPriorityDeque<int, LiveValue, ExactCapacity, PmrInterleavedLayout> local(4, &arena), other(4, &arena);
+        for (int key : { 4, 2, 6 }) local.emplace(key, key);
+        other = std::move(local);
+        ASSERT_EQ(other.size(), 3);
+        ASSERT_EQ(LiveValue::live, 3);
+    }
+    ASSERT_EQ(LiveValue::live, 0);
+}
+
+TEST(BoundedDequeTest, SlabLayout) {
+    for (size_t k : { 1, 2, 3, 7, 64, 100 }) {
+        checkAgainstReference<BoundedMinPriorityDeque<int, int, ExactCapacity, SlabLayout>>(k, static_cast<unsigned>(k));
+        checkAgainstReference<BoundedMinPriorityDeque<int, int, Pow2Capacity, SlabLayout>>(k, static_cast<unsigned>(k));
+        checkIterationAndLinearize<BoundedMinPriorityDeque<int, std::string, ExactCapacity, SlabLayout>>(k);
+    }
+    checkLazySlots<BoundedMinPriorityDeque<int, LiveValue, ExactCapacity, SlabLayout>>();
+    checkReservedResize<BoundedMinPriorityDeque<int, std::string, Pow2Capacity, SlabLayout>>();
+
+    BoundedMinPriorityDeque<int, std::string, ExactCapacity, SlabLayout> deque(8);
+    for (int key : { 50, 10, 90, 30, 70 }) deque.emplace(key, std::to_string(key));
+    const auto* thirty = &deque[1].value;
+    for (int key : { 20, 60, 40, 0 }) deque.emplace(key, std::to_string(key));
+    ASSERT_EQ(deque[3].value, "30");
+    ASSERT_EQ(&deque[3].value, thirty);
+
+    std::pmr::monotonic_buffer_resource arena;
+    BoundedMinPriorityDeque<int, std::string, ExactCapacity, PmrSlabLayout> local(4, &arena), other(4, &arena);
+    for (int key : { 4, 2, 6, 8, 1 }) local.emplace(key, std::to_string(key));
+    other += local;
+    local.clear();
+    for (int key : { 3, 5 }) local.emplace(key, std::to_string(key));
+    other += std::move(local);
+    ASSERT_EQ(other.size(), 4);
+    for (const auto* value : { "1", "2", "3", "4" }) ASSERT_EQ(other.pop().value, value);
+
+    // trivially destructible elements must still hand their slab slots back on every removal path
+    using TrivialSlabDeque = BoundedMinPriorityDeque<int, int, ExactCapacity, SlabLayout>;
+    auto checkContents = [](const TrivialSlabDeque& d, std::initializer_list<int> keys) {
+        ASSERT_EQ(d.size(), keys.size());
+        size_t i = 0;
+        for (int key : keys) {
+            ASSERT_EQ(d[i].key, key);
+            ASSERT_EQ(d[i++].value, key * 10);
+        }
+    };
+    TrivialSlabDeque trivial(4);
+    for (int round = 0; round < 3; ++round) {
+        for (int key : { 4, 2, 6, 8 }) trivial.emplace(key, key * 10);
+        trivial.clear();
+    }
+    for (int key : { 7, 5, 3, 1 }) trivial.emplace(key, key * 10);
+    checkContents(trivial, { 1, 3, 5, 7 });
+
+    TrivialSlabDeque better(4);
+    for (int round = 0; round < 3; ++round) {
+        for (int key : { 0, 2, 4, 6 }) better.emplace(key, key * 10);
+        trivial += better;
+        better.clear();
+    }
+    checkContents(trivial, { 0, 0, 0, 1 });
+    for (int round = 0; round < 3; ++round) {
+        for (int key : { 0, 2, 4, 6 }) better.emplace(key, key * 10);
+        trivial += std::move(better);
+    }
+    checkContents(trivial, { 0, 0, 0, 0 });
+
+    for (int round = 0; round < 3; ++round) {
+        trivial.resize(1);
+        trivial.resize(4);
+        for (int key : { -1, -2, -3 }) trivial.emplace(key, key * 10);
+    }
+    checkContents(trivial, { -3, -3, -2, -1 });
+
+    trivial.resize(16);
+    std::vector<BoundingPair<int, int>> elements;
+    for (int key = 100; key > 0; --key) elements.push_back({ key, key * 10 });
+    for (int round = 0; round < 3; ++round) trivial.pushRange(elements.begin(), elements.end());
+    checkContents(trivial, { -3, -3, -2, -1, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4 });
+}
+
+template<typename Compare>
+void checkHeapAgainstReference(size_t k, unsigned int seed) {
+    BoundedPriorityHeap<int, std::string, Compare> heap(k);
+    std::vector<int> reference;
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 1000);
+    Compare comp;
+
+    for (int i = 0; i < 5000; ++i) {
+        auto operation = distribution(generator) % 10;
+        if (operation == 0 && !reference.empty()) {
+            auto element = heap.pop();
+            ASSERT_EQ(element.key, reference.front());
+            ASSERT_EQ(element.value, std::to_string(element.key));
+            reference.erase(reference.begin());
+        } else if (operation == 1 && !reference.empty()) {
+            ASSERT_EQ(heap.popBottom().key, reference.back());
+            reference.pop_back();
+        } else {
+            int key = distribution(generator);
+            heap.emplace(key, std::to_string(key));
+            reference.insert(std::upper_bound(reference.begin(), reference.end(), key, comp), key);
+            if (reference.size() > k) reference.pop_back();
+        }
+
+        ASSERT_EQ(heap.size(), reference.size());
+        if (!reference.empty()) {
+            ASSERT_EQ(heap.topK(), reference.front());
+            ASSERT_EQ(heap.bottomK(), reference.back());
+        }
+    }
+
+    auto sorted = heap.sorted();
+    ASSERT_EQ(sorted.size(), reference.size());
+    for (size_t i = 0; i < sorted.size(); ++i) ASSERT_EQ(sorted[i].key, reference[i]);
+}
+
+TEST(BoundedDequeTest, HeapBackend) {
+    for (size_t k : { 1, 2, 3, 7, 64, 300 }) {
+        checkHeapAgainstReference<std::less<int>>(k, static_cast<unsigned>(k));
+        checkHeapAgainstReference<std::greater<int>>(k, static_cast<unsigned>(k) + 1);
+    }
+
+    BoundedPriorityHeap<double, int> a(4), b(4);
+    ASSERT_EQ(a.threshold(), std::numeric_limits<double>::infinity());
+    for (int key : { 9, 3, 7, 1, 5 }) a.emplace(key, key);
+    ASSERT_EQ(a.threshold(), 7);
+    for (int key : { 2, 8, 4 }) b.emplace(key, key);
+    a += b;
+    a += a;
+    ASSERT_EQ(a.size(), 4);
+    ASSERT_EQ(b.size(), 3);
+    a.resize(3);
+    for (int key : { 1, 1, 2 }) ASSERT_EQ(a.pop().key, key);
+    a += std::move(b);
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(a.topK(), 2);
+    ASSERT_EQ(a.bottomK(), 8);
+
+    LiveValue::live = 0;
+    {
+        BoundedPriorityHeap<int, LiveValue> values(3);
+        for (int key : { 5, 3, 9, 7, 1 }) values.emplace(key, key);
+        ASSERT_EQ(LiveValue::live, 3);
+        ASSERT_EQ(values.bottom().value.payload, "5");
+    }
+    ASSERT_EQ(LiveValue::live, 0);
+
+    static_assert(std::is_same_v<BoundedPriorityDequeFor<double, int, 10>, BoundedPriorityDequeKeyed<double, int>>);
+    static_assert(std::is_same_v<BoundedPriorityDequeFor<double, int, 50000, std::greater<>>,
+                                 BoundedPriorityHeap<double, int, std::greater<>>>);
+    BoundedPriorityDequeFor<double, int, 50000> large(50000);
+    ASSERT_TRUE(large.empty());
+}
+
+TEST(BoundedDequeTest, LazyCollectThenFinalize) {
+    for (size_t k : { 1, 2, 5, 64, 300 }) {
+        LazyBoundedPriorityDeque<int, std::string> lazy(k);
+        BoundedMinPriorityDeque<int, std::string> reference(k);
+        std::mt19937 generator(static_cast<unsigned>(k));
+        std::uniform_int_distribution<int> distribution(0, 100000);
+
+        for (int i = 0; i < 5000; ++i) {
+            auto operation = distribution(generator) % 50;
+            if (operation == 0 && !reference.empty()) {
+                auto element = lazy.pop();
+                ASSERT_EQ(element.key, reference.pop().key);
+                ASSERT_EQ(element.value, std::to_string(element.key));
+            } else if (operation == 1 && !reference.empty()) {
+                ASSERT_EQ(lazy.popBottom().key, reference.popBottom().key);
+            } else {
+                int key = distribution(generator);
+                lazy.emplace(key, std::to_string(key));
+                reference.emplace(key, std::to_string(key));
+            }
+            ASSERT_EQ(lazy.size(), reference.size());
+        }
+
+        ASSERT_TRUE(std::ranges::equal(lazy, reference, {}, &BoundingPair<int, std::string>::key,
+                                       &BoundingPair<int, std::string>::key));
+        for (size_t i = 0; i < reference.size(); ++i) ASSERT_EQ(lazy[i].key, reference[i].key);
+    }
+
+    LazyBoundedPriorityDeque<double, int, std::greater<>> a(3), b(3);
+    ASSERT_EQ(a.threshold(), -std::numeric_limits<double>::infinity());
+    for (int key : { 4, 9, 1, 7, 3, 8, 2 }) a.emplace(key, key);
+    ASSERT_EQ(a.threshold(), 7);
+    a.emplace(7, 7);
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(a.topK(), 9);
+    ASSERT_EQ(a.bottomK(), 7);
+    for (int key : { 10, 5 }) b.emplace(key, key);
+    a += b;
+    a += a;
+    ASSERT_EQ(b.size(), 2);
+    a.resize(2);
+    ASSERT_EQ(a.bottomK(), 10);
+    a += std::move(b);
+    ASSERT_TRUE(b.empty());
+    for (int key : { 10, 10 }) ASSERT_EQ(a.pop().key, key);
+    ASSERT_TRUE(a.empty());
+
+    LiveValue::live = 0;
+    {
+        LazyBoundedPriorityDeque<int, LiveValue> values(2);
+        for (int key : { 5, 3, 9, 7, 1 }) values.emplace(key, key);
+        ASSERT_EQ(LiveValue::live, 3);
+        values.finalize();
+        ASSERT_EQ(LiveValue::live, 2);
+        ASSERT_EQ(values.bottom().value.payload, "3");
+    }
+    ASSERT_EQ(LiveValue::live, 0);
+}
+
+TEST(BoundedDequeTest, BatchMatchesSeparateDeques) {
+    constexpr size_t queries = 7;
+    for (size_t k : { 1, 4, 40 }) {
+        BoundedPriorityDequeBatch<int, int> batch(queries, k);
+        std::vector<BoundedMinPriorityDeque<int, int>> reference(queries, BoundedMinPriorityDeque<int, int>(k));
+        std::mt19937 generator(static_cast<unsigned>(k));
+        std::uniform_int_distribution<int> distribution(0, 500);
+
+        std::vector<int> keys(queries), values(queries);
+        for (int round = 0; round < 400; ++round) {
+            for (size_t q = 0; q < queries; ++q) {
+                keys[q] = distribution(generator);
+                values[q] = round;
+                reference[q].emplace(keys[q], round);
+            }
+            if (round % 2 == 0) batch.pushAll(keys, values);
+            else for (size_t q = 0; q < queries; ++q) batch.push(q, keys[q], values[q]);
+
+            if (round % 97 == 0) {
+                ASSERT_EQ(batch.pop(round % queries).key, reference[round % queries].pop().key);
+            }
+        }
+
+        for (size_t q = 0; q < queries; ++q) {
+            ASSERT_EQ(batch.size(q), reference[q].size());
+            ASSERT_EQ(batch.threshold(q), reference[q].threshold());
+            ASSERT_EQ(batch.bottomK(q), reference[q].bottomK());
+            for (size_t i = 0; i < batch.size(q); ++i) {
+                ASSERT_EQ(batch.element(q, i).key, reference[q][i].key);
+                ASSERT_EQ(batch.element(q, i).value, reference[q][i].value);
+            }
+        }
+    }
+
+    BoundedPriorityDequeBatch<double, int, std::greater<>> batch(2, 2);
+    ASSERT_TRUE(batch.admits(0, 1.0));
+    batch.push(0, 1.0, 1);
+    batch.push(0, 3.0, 3);
+    batch.push(0, 2.0, 2);
+    ASSERT_TRUE(batch.full(0));
+    ASSERT_TRUE(batch.empty(1));
+    ASSERT_FALSE(batch.admits(0, 2.0));
+    ASSERT_EQ(batch.threshold(0), 2.0);
+    ASSERT_EQ(batch.threshold(1), -std::numeric_limits<double>::infinity());
+    ASSERT_EQ(batch.top(0).value, 3);
+    batch.clear(0);
+    ASSERT_TRUE(batch.empty(0));
+    ASSERT_THROW(batch.push(2, 1.0, 1), std::runtime_error);
+    ASSERT_THROW((void) batch.admits(2, 1.0), std::runtime_error);
+    std::array<double, 1> shortKeys { 5.0 };
+    std::array<int, 2> values { 5, 5 };
+    ASSERT_THROW(batch.pushAll(shortKeys, values), std::runtime_error);
+    ASSERT_TRUE(batch.empty(0));
+    ASSERT_THROW((void) batch.top(1), std::runtime_error);
+    ASSERT_THROW((void) batch.pop(1), std::runtime_error);
+    ASSERT_TRUE(batch.empty(1));
+    batch.push(1, 4.0, 4);
+    ASSERT_THROW((void) batch.element(1, 1), std::runtime_error);
+    ASSERT_EQ(batch.pop(1).value, 4);
+    ASSERT_TRUE(batch.empty(1));
+
+    // capacity zero admits nothing, even keys that outrank the default constructed bottom keys
+    BoundedPriorityDequeBatch<double, int> none(3, 0);
+    std::array<double, 3> keys { -1.0, 0.0, std::numeric_limits<double>::lowest() };
+    std::array<int, 3> ids { 1, 2, 3 };
+    for (size_t q = 0; q < 3; ++q) {
+        ASSERT_FALSE(none.admits(q, keys[q]));
+        none.push(q, keys[q], ids[q]);
+    }
+    none.pushAll(keys, ids);
+    for (size_t q = 0; q < 3; ++q) ASSERT_TRUE(none.empty(q));
+    ASSERT_EQ(none.threshold(0), -std::numeric_limits<double>::infinity());
+}
+
+TEST(BoundedDequeTest, SnapshotRoundTrip) {
+    BoundedMinPriorityDeque<double, int> interleaved(6);
+    BoundedMinPriorityDeque<double, int, Pow2Capacity, SplitLayout> split(6);
+    for (int key : { 9, 4, 7, 1, 8, 3, 2, 6 }) {
+        interleaved.emplace(key, key * 10);
+        split.emplace(key, key * 10);
+    }
+    BoundedMinPriorityDeque<double, int> empty(3);
+
+    alignas(DequeSnapshot::alignment) std::array<std::byte, 512> records {};
+    std::span<std::byte> out(records);
+    auto first = interleaved.serialize(out);
+    ASSERT_EQ(first, interleaved.serializedSize());
+    ASSERT_EQ(first % DequeSnapshot::alignment, 0);
+    auto second = split.serialize(out.subspan(first));
+    ASSERT_EQ(second, first);
+    ASSERT_TRUE(std::ranges::equal(out.first(first), out.subspan(first, second)));
+    auto third = empty.serialize(out.subspan(first + second));
+
+    BoundedMinPriorityDeque<double, int, ExactCapacity, SplitLayout> restored(1);
+    std::span<const std::byte> in(records);
+    ASSERT_EQ(restored.deserialize(in), first);
+    ASSERT_EQ(restored.capacity(), 6);
+    ASSERT_TRUE(std::ranges::equal(restored, interleaved, {}, [](auto element) { return element.value; },
+                                   [](auto element) { return element.value; }));
+    restored.emplace(0, 0);
+    ASSERT_EQ(restored.topK(), 0);
+    ASSERT_EQ(restored.bottomK(), 6);
+
+    BoundedPriorityDequeView<double, int> view(in.subspan(first));
+    ASSERT_EQ(view.size(), 6);
+    ASSERT_TRUE(view.full());
+    ASSERT_EQ(view.topK(), 1);
+    ASSERT_EQ(view.bottom().value, 70);
+    ASSERT_EQ(view.threshold(), interleaved.threshold());
+    ASSERT_TRUE(std::ranges::equal(view.keys(), std::array { 1.0, 2.0, 3.0, 4.0, 6.0, 7.0 }));
+    ASSERT_EQ(view[3].value, 40);
+
+    BoundedPriorityDequeView<double, int> last(in.subspan(first + view.serializedSize()));
+    ASSERT_TRUE(last.empty());
+    ASSERT_EQ(last.capacity(), 3);
+    ASSERT_EQ(last.serializedSize(), third);
+    ASSERT_EQ(restored.deserialize(in.subspan(first + second)), third);
+    ASSERT_TRUE(restored.empty());
+    ASSERT_EQ(restored.capacity(), 3);
+
+    // corrupt and truncated records are rejected in every build, before the deque is touched
+    auto corrupt = [&](auto&& edit) {
+        alignas(DequeSnapshot::alignment) std::array<std::byte, 512> copy = records;
+        DequeSnapshot::Header header;
+        std::memcpy(&header, copy.data(), sizeof(header));
+        edit(header);
+        std::memcpy(copy.data(), &header, sizeof(header));
+        std::span<const std::byte> record(copy);
+        ASSERT_THROW((BoundedPriorityDequeView<double, int> { record }), std::runtime_error);
+        ASSERT_THROW(restored.deserialize(record), std::runtime_error);
+        ASSERT_THROW(restored.deserialize(record.first(first - 1)), std::runtime_error);
+    };
+    corrupt([](auto& header) { header.size = header.capacity + 1; });
+    corrupt([](auto& header) { header.size = header.capacity = std::numeric_limits<uint64_t>::max() / 2; });
+    corrupt([](auto& header) { header.version = 2; });
+    ASSERT_THROW(restored.deserialize(in.first(16)), std::runtime_error);
+    ASSERT_THROW((BoundedPriorityDequeView<double, int> { in.first(first - 1) }), std::runtime_error);
+    ASSERT_THROW((BoundedPriorityDequeView<double, int> { in.subspan(8) }), std::runtime_error);
+    ASSERT_EQ(restored.capacity(), 3);
+
+    records[0] = std::byte { 0 };
+    ASSERT_THROW((BoundedPriorityDequeView<double, int> { in }), std::runtime_error);
+    ASSERT_THROW((BoundedPriorityDequeView<float, int> { in.subspan(first) }), std::runtime_error);
+    ASSERT_THROW(interleaved.serialize(out.first(8)), std::runtime_error);
+}
+
+#ifdef ENABLE_DEQUE_STATS
+TEST(BoundedDequeTest, StatsCounters) {
+    BoundedMinPriorityDeque<int, int> deque(100);
+    for (int key = 1; key <= 100; ++key) deque.emplace(key, key);
+    ASSERT_EQ(deque.stats().accepted, 100);
+    ASSERT_EQ(deque.stats().bottomInserts, 99);
+
+    deque.emplace(0, 0);
+    deque.emplace(200, 200);
+    deque.emplace(50, 50);
+    const auto& stats = deque.stats();
+    ASSERT_EQ(stats.accepted, 102);
+    ASSERT_EQ(stats.rejected, 1);
+    ASSERT_EQ(stats.topInserts, 1);
+    ASSERT_EQ(stats.searchedInserts, 1);
+    ASSERT_EQ(stats.shifted, 49);
+    ASSERT_GT(stats.probes, 0);
+
+    BoundedMinPriorityDeque<int, int> other(100);
+    deque += other;
+    deque.reserve(1000);
+    deque.resize(500);
+    ASSERT_EQ(stats.mergeEarlyExits, 1);
+    ASSERT_EQ(stats.reallocations, 1);
+
+    deque.resetStats();
+    ASSERT_EQ(stats.accepted, 0);
+
+    BoundedMinPriorityDeque<int, int> small(3);
+    for (int key : { 1, 2, 3, 0, 1 }) small.emplace(key, key);
+    ASSERT_EQ(small.stats().bottomInserts, 2);
+    ASSERT_EQ(small.stats().topInserts, 1);
+    ASSERT_EQ(small.stats().searchedInserts, 1);
+    ASSERT_EQ(small.stats().shifted, 1);
+}
+#endif
+
+template<typename Compare>
+void checkApproximateAgainstExact(size_t k, unsigned int seed) {
+    ApproximateBoundedPriorityDeque<double, int, Compare> approximate(k, 0.0, 1.0, 256);
+    BoundedPriorityDequeKeyed<double, int, Compare> exact(k);
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+    for (int i = 0; i < 20000; ++i) {
+        auto key = distribution(generator);
+        approximate.emplace(key, i);
+        exact.emplace(key, i);
+        if (i % 5000 == 2499) {
+            auto popped = approximate.pop().key;
+            ASSERT_LT(std::abs(popped - exact.pop().key), approximate.resolution());
+        }
+        ASSERT_EQ(approximate.size(), exact.size());
+    }
+
+    ASSERT_TRUE(approximate.full());
+    auto boundary = std::floor(exact.bottomK() / approximate.resolution());
+    for (size_t i = 0; i < k; ++i) {
+        ASSERT_LT(std::abs(approximate[i].key - exact[i].key), approximate.resolution());
+        if (std::floor(exact[i].key / approximate.resolution()) != boundary) {
+            ASSERT_EQ(approximate[i].value, exact[i].value);
+        }
+    }
+}
+
+TEST(BoundedDequeTest, ApproximateBoundedError) {
+    for (size_t k : { 1, 10, 500 }) {
+        checkApproximateAgainstExact<std::less<>>(k, static_cast<unsigned>(k));
+        checkApproximateAgainstExact<std::greater<>>(k, static_cast<unsigned>(k) + 1);
+    }
+
+    ApproximateBoundedPriorityDeque<int, int> a(3, 0, 100, 10), b(3, 0, 100, 10);
+    ASSERT_EQ(a.resolution(), 10);
+    ASSERT_EQ(a.threshold(), std::numeric_limits<int>::max());
+    for (int key : { 55, 12, 31, 48 }) a.emplace(key, key);
+    ASSERT_EQ(a.threshold(), 40);
+    a.emplace(45, 45);
+    a.emplace(40, 40);
+    ASSERT_EQ(a.bottomK(), 48);
+    for (int key : { 5, 95 }) b.emplace(key, key);
+    a += b;
+    a += a;
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(b.size(), 2);
+    ASSERT_EQ(a.popBottom().key, 12);
+    a += std::move(b);
+    ASSERT_TRUE(b.empty());
+    for (int key : { 5, 5, 5 }) ASSERT_EQ(a.pop().key, key);
+    ASSERT_TRUE(a.empty());
+
+    ApproximateBoundedPriorityDeque<float, int> none(0, 0.0f, 1.0f);
+    none.emplace(0.5f, 1);
+    ASSERT_TRUE(none.empty());
+
+    constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+    constexpr auto inf = std::numeric_limits<double>::infinity();
+    ASSERT_THROW((ApproximateBoundedPriorityDeque<int, int>(3, 5, 5)), std::runtime_error);
+    ASSERT_THROW((ApproximateBoundedPriorityDeque<double, int>(3, 1.0, 0.0)), std::runtime_error);
+    ASSERT_THROW((ApproximateBoundedPriorityDeque<double, int>(3, nan, 1.0)), std::runtime_error);
+    ASSERT_THROW((ApproximateBoundedPriorityDeque<double, int>(3, 0.0, inf)), std::runtime_error);
+
+    auto checkNaN = [nan](auto deque, double best, double worst) {
+        deque.emplace(nan, 0);
+        ASSERT_TRUE(deque.empty());
+        for (double key : { worst, nan, best, nan }) deque.emplace(key, 1);
+        ASSERT_EQ(deque.size(), 2);
+        deque.emplace(nan, 2);
+        ASSERT_EQ(deque.size(), 2);
+        ASSERT_EQ(deque.pop().key, best);
+        ASSERT_EQ(deque.pop().key, worst);
+    };
+    checkNaN(ApproximateBoundedPriorityDeque<double, int>(2, 0.0, 1.0, 8), 0.25, 0.75);
+    checkNaN(ApproximateBoundedPriorityDeque<double, int, std::greater<>>(2, 0.0, 1.0, 8), 0.75, 0.25);
+}
+
 class ConcurrentDequeTest : public ::testing::Test {
 protected:
-    BoundedMinPriorityDeque<int, std::string> deque;
-    std::mutex mutex;
-    static constexpr int kMaxItems = 1000;
+    ConcurrentBoundedPriorityDeque<int, std::string> deque;
+    static constexpr int kMaxItems = 40000;
     static constexpr int kCapacity = 100;
 
-    ConcurrentDequeTest() : deque(kCapacity) {}
+    ConcurrentDequeTest() : deque(kCapacity, 4) {}
+
+    static std::vector<int> generate(int seed, int count) {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> distribution(1, 1000000);
+        std::vector<int> numbers(count);
+        for (auto& num : numbers) num = distribution(generator);
+        return numbers;
+    }
 
     void fillDequeConcurrently(int num_threads, int items_per_thread) {
         auto pushToDeque = [this](int seed, int count) {
-            std::mt19937 generator(seed);
-            std::uniform_int_distribution<int> distribution(1, 10000);
-            for (int i = 0; i < count; ++i) {
-                int num = distribution(generator);
-                std::lock_guard<std::mutex> lock(this->mutex);
+            for (int num : generate(seed, count)) {
                 this->deque.push(BoundingPair<int, std::string>(num, "Value: " + std::to_string(num)));
             }
         };
@@ -208,34 +1457,204 @@ protected:
     }
 };
 
-//TEST_F(ConcurrentDequeTest, MultiThreadedPush) {
-//    const int num_threads = 2;
-//    const int num_operations_per_thread = kMaxItems / num_threads;
-//
-//    fillDequeConcurrently(num_threads, num_operations_per_thread);
-//
-//    // Verify that the capacity is not exceeded
-//    ASSERT_LE(deque.size(), kCapacity);
-//
-//    // Verify the consistency and integrity of the deque
-//    std::vector<int> values;
-//    while (!deque.empty()) {
-//        std::string topValue = deque.top().value;
-//        values.push_back(std::stoi(topValue.substr(7))); // Extract the number from the string
-//        deque.pop();
-//    }
-//
-//    // Ensure all values are unique since they should be
-//    std::sort(values.begin(), values.end());
-//    auto last = std::unique(values.begin(), values.end());
-//    ASSERT_TRUE(last == values.end());
-//
-//    // Ensure values are in increasing order since it's a min-deque
-//    for (size_t i = 1; i < values.size(); ++i) {
-//        ASSERT_LE(values[i - 1], values[i]);
-//    }
-//}
+TEST_F(ConcurrentDequeTest, MultiThreadedPush) {
+    const int num_threads = 8;
+    const int num_operations_per_thread = kMaxItems / num_threads;
+
+    fillDequeConcurrently(num_threads, num_operations_per_thread);
+    auto result = deque.collect();
+
+    // Verify that the capacity is not exceeded
+    ASSERT_EQ(result.size(), kCapacity);
+
+    // Verify the result against the sequentially computed top-k of the same candidates
+    std::vector<int> reference;
+    for (int i = 0; i < num_threads; ++i) {
+        auto numbers = generate(i, num_operations_per_thread);
+        reference.insert(reference.end(), numbers.begin(), numbers.end());
+    }
+    std::sort(reference.begin(), reference.end());
+
+    for (int i = 0; i < kCapacity; ++i) {
+        auto element = result.pop();
+        ASSERT_EQ(element.key, reference[i]);
+        ASSERT_EQ(element.value, "Value: " + std::to_string(reference[i]));
+    }
+    ASSERT_FALSE(deque.rejects(reference[kCapacity - 1]));
+    ASSERT_TRUE(deque.rejects(reference[kCapacity - 1] + 1));
+    ASSERT_FALSE(deque.rejects(reference[0]));
+}
+
+TEST_F(ConcurrentDequeTest, CollectWhilePushing) {
+    std::atomic<bool> done = false;
+    std::thread reader([this, &done] {
+        while (!done.load()) {
+            auto snapshot = deque.collect();
+            for (size_t i = 1; i < snapshot.size(); ++i) ASSERT_LE(snapshot[i - 1].key, snapshot[i].key);
+        }
+    });
+    fillDequeConcurrently(6, kMaxItems / 6);
+    done = true;
+    reader.join();
+    ASSERT_EQ(deque.collect().size(), kCapacity);
+
+    deque.clear();
+    ASSERT_TRUE(deque.collect().empty());
+    ASSERT_FALSE(deque.rejects(1000000));
+}
+
+
+TEST(ShardedDequeTest, CollectMatchesSequential) {
+    constexpr int threadCount = 6, perThread = 5000;
+    ShardedBoundedPriorityDeque<BoundedMaxPriorityDeque<int, int>> sharded(50, threadCount);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&sharded, t] {
+            auto local = sharded.local(static_cast<size_t>(t));
+            std::mt19937 generator(t);
+            std::uniform_int_distribution<int> distribution(0, 100000);
+            for (int i = 0; i < perThread; ++i) local.emplace(distribution(generator), t);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    std::vector<int> reference;
+    for (int t = 0; t < threadCount; ++t) {
+        std::mt19937 generator(t);
+        std::uniform_int_distribution<int> distribution(0, 100000);
+        for (int i = 0; i < perThread; ++i) reference.push_back(distribution(generator));
+    }
+    std::sort(reference.begin(), reference.end(), std::greater<>());
+
+    auto result = sharded.collect();
+    ASSERT_EQ(result.size(), 50);
+    for (size_t i = 0; i < result.size(); ++i) ASSERT_EQ(result[i].key, reference[i]);
+    ASSERT_FALSE(sharded.local(0).rejects(reference[49]));
+    ASSERT_TRUE(sharded.local(0).rejects(reference[49] - 1));
+    ASSERT_FALSE(sharded.local(0).rejects(reference[48] + 1));
+}
 
+TEST(ShardedDequeTest, DeterministicTiesAndThreshold) {
+    ShardedBoundedPriorityDeque<BoundedMinPriorityDeque<int, std::string>> sharded(2, 3);
+    sharded.local(2).emplace(1, "shard 2");
+    sharded.local(0).emplace(1, "shard 0");
+    sharded.local(1).emplace(1, "shard 1");
+
+    auto first = sharded.local(0);
+    first.emplace(5, "five");
+    ASSERT_FALSE(first.rejects(5));
+    ASSERT_TRUE(sharded.local(1).rejects(6));
+    sharded.local(1).emplace(9, "pruned");
+    ASSERT_EQ(sharded.local(1).deque().size(), 1);
+
+    auto result = sharded.collect();
+    ASSERT_EQ(result.size(), 2);
+    ASSERT_EQ(result[0].value, "shard 0");
+    ASSERT_EQ(result[1].value, "shard 1");
+
+    sharded.clear();
+    ASSERT_TRUE(sharded.collect().empty());
+    ASSERT_FALSE(sharded.local().rejects(100));
+}
+
+TEST(ShardedDequeTest, ThreadedTiesMatchSequential) {
+    constexpr size_t shardCount = 8, perShard = 4000, k = 64;
+    using Sharded = ShardedBoundedPriorityDeque<BoundedMinPriorityDeque<int, int>>;
+    // a handful of distinct keys, so the k-th key is shared by elements of every shard
+    auto fill = [](Sharded& sharded, size_t shard) {
+        auto local = sharded.local(shard);
+        std::mt19937 generator(static_cast<unsigned>(shard));
+        std::uniform_int_distribution<int> distribution(0, 9);
+        for (size_t i = 0; i < perShard; ++i) local.emplace(distribution(generator), static_cast<int>(shard * perShard + i));
+    };
+    auto values = [](Sharded& sharded) {
+        std::vector<int> collected;
+        for (const auto& element : sharded.collect()) collected.push_back(element.value);
+        return collected;
+    };
+
+    // the last shard fills and publishes first, the reverse of the order ties are resolved in
+    Sharded sequential(k, shardCount);
+    for (size_t shard = shardCount; shard-- > 0;) fill(sequential, shard);
+    auto reference = values(sequential);
+    ASSERT_EQ(reference.size(), k);
+
+    for (int run = 0; run < 20; ++run) {
+        Sharded sharded(k, shardCount);
+        std::vector<std::thread> threads;
+        for (size_t shard = 0; shard < shardCount; ++shard) threads.emplace_back(fill, std::ref(sharded), shard);
+        for (auto& thread : threads) thread.join();
+        ASSERT_EQ(values(sharded), reference);
+    }
+}
+
+TEST(ParallelTopKTest, MatchesSequential) {
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> distribution(0, 1000000);
+    std::vector<int> keys(50000);
+    for (auto& key : keys) key = distribution(generator);
+    std::vector<int> reference = keys;
+    std::sort(reference.begin(), reference.end(), std::greater<>());
+
+    auto threaded = parallelTopK<std::greater<>>(keys, 40, [](int key) { return key; });
+    ASSERT_EQ(threaded.size(), 40);
+    for (size_t i = 0; i < threaded.size(); ++i) ASSERT_EQ(threaded[i].key, reference[i]);
+
+    // indices instead of copies, the iota view is a borrowed range
+    size_t scheduled = 0;
+    auto indices = parallelTopK(std::views::iota(size_t(0), keys.size()), 25, [&keys](size_t i) { return -keys[i]; },
+                                [&scheduled](auto task) { ++scheduled; task(); }, 8);
+    ASSERT_EQ(scheduled, 8);
+    ASSERT_EQ(indices.size(), 25);
+    for (size_t i = 0; i < indices.size(); ++i) ASSERT_EQ(keys[indices[i].value], reference[i]);
+
+    std::vector<int> few = { 5, 3, 9 };
+    auto all = parallelTopK(few, 8, [](int key) { return key; }, [](auto task) { task(); });
+    ASSERT_EQ(all.size(), 3);
+    ASSERT_EQ(all.topK(), 3);
+    ASSERT_TRUE(parallelTopK(std::vector<int>(), 4, [](int key) { return key; }).empty());
+}
+
+TEST(ParallelTopKTest, AsyncCompletionAndErrors) {
+    std::vector<double> keys(20000);
+    for (size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<double>((i * 7919) % keys.size());
+
+    // tasks are only queued, the call returns before any work ran and the last task delivers the result
+    std::vector<std::function<void()>> queue;
+    std::optional<BoundedPriorityDequeBase<double, double, std::less<>>> result;
+    parallelTopKAsync(keys, 10, [](double key) { return key; }, [&queue](auto task) { queue.emplace_back(task); },
+                      [&result](std::exception_ptr error, auto&& deque) {
+                          ASSERT_FALSE(error);
+                          result.emplace(std::move(deque));
+                      }, 4);
+    ASSERT_EQ(queue.size(), 4);
+    ASSERT_FALSE(result);
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it) (*it)();
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result->size(), 10);
+    for (size_t i = 0; i < result->size(); ++i) ASSERT_EQ((*result)[i].key, static_cast<double>(i));
+
+    auto throwing = [](double key) {
+        if (key == 12345) throw std::invalid_argument("bad key");
+        return key;
+    };
+    ASSERT_THROW((void) parallelTopK(keys, 10, throwing), std::invalid_argument);
+
+    size_t scheduled = 0;
+    std::exception_ptr failure;
+    parallelTopKAsync(keys, 10, [](double key) { return key; },
+                      [&scheduled](auto task) {
+                          if (scheduled++ == 2) throw std::runtime_error("executor is shutting down");
+                          task();
+                      },
+                      [&failure](std::exception_ptr error, auto&& deque) {
+                          failure = error;
+                          ASSERT_TRUE(deque.empty());
+                      }, 4);
+    ASSERT_TRUE(failure);
+    ASSERT_THROW(std::rethrow_exception(failure), std::runtime_error);
+}
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);